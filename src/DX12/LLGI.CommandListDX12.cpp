@@ -165,12 +165,15 @@ void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 		currentCommandList_->OMSetRenderTargets(renderPass_->GetCount(), renderPass_->GetHandleRTV(), FALSE, renderPass_->GetHandleDSV());
 
 		// Reset scissor
+		// a depth only pass uses one viewport
+		const auto viewportCount = renderPass_->GetCount() > 0 ? renderPass_->GetCount() : 1;
 		D3D12_RECT rects[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
 		D3D12_VIEWPORT viewports[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
-		for (int i = 0; i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT && i < renderPass_->GetCount(); i++)
+		for (int i = 0; i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT && i < viewportCount; i++)
 		{
-			auto size = (renderPass_->GetRenderTarget(i)->texture_ != nullptr) ? renderPass_->GetRenderTarget(i)->texture_->GetSizeAs2D()
-																			   : renderPass_->GetScreenSize();
+			auto size = (i < renderPass_->GetCount() && renderPass_->GetRenderTarget(i)->texture_ != nullptr)
+							? renderPass_->GetRenderTarget(i)->texture_->GetSizeAs2D()
+							: renderPass_->GetScreenSize();
 			rects[i].top = 0;
 			rects[i].left = 0;
 			rects[i].right = size.X;
@@ -183,8 +186,8 @@ void CommandListDX12::BeginRenderPass(RenderPass* renderPass)
 			viewports[i].MinDepth = 0.0f;
 			viewports[i].MaxDepth = 1.0f;
 		}
-		currentCommandList_->RSSetScissorRects(renderPass_->GetCount(), rects);
-		currentCommandList_->RSSetViewports(renderPass_->GetCount(), viewports);
+		currentCommandList_->RSSetScissorRects(viewportCount, rects);
+		currentCommandList_->RSSetViewports(viewportCount, viewports);
 
 		if (renderPass_->GetIsColorCleared())
 		{
@@ -571,4 +574,6 @@ void CommandListDX12::WaitUntilCompleted()
 	}
 }
 
+bool CommandListDX12::IsCompleted() { return fence_->GetCompletedValue() >= fenceValue_ - 1; }
+
 } // namespace LLGI
@@ -64,6 +64,8 @@ public:
 	UINT64 GetAndIncFenceValue();
 
 	void WaitUntilCompleted() override;
+
+	bool IsCompleted() override;
 };
 
 } // namespace LLGI
@@ -35,6 +35,10 @@ GraphicsDX12::GraphicsDX12(ID3D12Device* device,
 	// Create Command Allocator
 	hr = device->CreateCommandAllocator(commandListType_, IID_PPV_ARGS(&commandAllocator_));
 	assert(SUCCEEDED(hr));
+
+	hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(hr));
+	fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
 }
 
 GraphicsDX12::~GraphicsDX12()
@@ -44,21 +48,86 @@ GraphicsDX12::~GraphicsDX12()
 	SafeRelease(device_);
 	SafeRelease(commandQueue_);
 	SafeRelease(commandAllocator_);
+	SafeRelease(fence_);
+
+	if (fenceEvent_ != nullptr)
+	{
+		CloseHandle(fenceEvent_);
+		fenceEvent_ = nullptr;
+	}
+
 	SafeRelease(owner_);
 }
 
-void GraphicsDX12::Execute(CommandList* commandList)
+SyncPoint GraphicsDX12::Execute(CommandList* commandList)
 {
 	if (commandList->GetIsInRenderPass())
 	{
 		Log(LogType::Error, "Please call Execute outside of RenderPass");
-		return;
+		return SyncPoint();
 	}
 
 	auto cl = (CommandListDX12*)commandList;
 	auto cl_internal = cl->GetCommandList();
 	commandQueue_->ExecuteCommandLists(1, (ID3D12CommandList**)(&cl_internal));
 	commandQueue_->Signal(cl->GetFence(), cl->GetAndIncFenceValue());
+
+	if (fence_ == nullptr)
+	{
+		return SyncPoint();
+	}
+
+	fenceValue_++;
+	commandQueue_->Signal(fence_, fenceValue_);
+
+	SyncPoint syncPoint;
+	syncPoint.Value = fenceValue_;
+	return syncPoint;
+}
+
+bool GraphicsDX12::Wait(const SyncPoint& syncPoint)
+{
+	if (!syncPoint.IsValid() || fence_ == nullptr)
+	{
+		return Graphics::Wait(syncPoint);
+	}
+
+	if (fence_->GetCompletedValue() < syncPoint.Value)
+	{
+		auto hr = fence_->SetEventOnCompletion(syncPoint.Value, fenceEvent_);
+		if (FAILED(hr))
+		{
+			return false;
+		}
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
+
+	return true;
+}
+
+bool GraphicsDX12::IsCompleted(const SyncPoint& syncPoint)
+{
+	if (!syncPoint.IsValid())
+	{
+		return true;
+	}
+
+	if (fence_ == nullptr)
+	{
+		return false;
+	}
+
+	return fence_->GetCompletedValue() >= syncPoint.Value;
+}
+
+void GraphicsDX12::WaitOnGPU(const SyncPoint& syncPoint)
+{
+	if (!syncPoint.IsValid() || fence_ == nullptr)
+	{
+		return;
+	}
+
+	commandQueue_->Wait(fence_, syncPoint.Value);
 }
 
 void GraphicsDX12::WaitFinish()
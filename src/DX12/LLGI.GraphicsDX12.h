@@ -28,6 +28,11 @@ private:
 	ID3D12CommandAllocator* commandAllocator_ = nullptr;
 	ReferenceObject* owner_ = nullptr;
 
+	//! a fence which is signaled on the queue after each execution to provide sync points
+	ID3D12Fence* fence_ = nullptr;
+	HANDLE fenceEvent_ = nullptr;
+	UINT64 fenceValue_ = 0;
+
 	std::unordered_map<RenderPassPipelineStateKey, std::shared_ptr<RenderPassPipelineStateDX12>, RenderPassPipelineStateKey::Hash>
 		renderPassPipelineStates_;
 
@@ -40,8 +45,11 @@ public:
 				 ReferenceObject* owner = nullptr);
 	~GraphicsDX12() override;
 
-	void Execute(CommandList* commandList) override;
+	SyncPoint Execute(CommandList* commandList) override;
 	void WaitFinish() override;
+	bool Wait(const SyncPoint& syncPoint) override;
+	bool IsCompleted(const SyncPoint& syncPoint) override;
+	void WaitOnGPU(const SyncPoint& syncPoint) override;
 
 	VertexBuffer* CreateVertexBuffer(int32_t size) override;
 	IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count) override;
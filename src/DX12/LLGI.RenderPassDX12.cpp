@@ -25,7 +25,8 @@ RenderPassDX12 ::~RenderPassDX12()
 bool RenderPassDX12::Initialize(
 	TextureDX12** textures, int numTextures, TextureDX12* depthTexture, TextureDX12* resolvedTexture, TextureDX12* resolvedDepthTexture)
 {
-	if (textures[0]->Get() == nullptr)
+	// a depth only pass has no render texture
+	if (numTextures > 0 && textures[0]->Get() == nullptr)
 		return false;
 
 	if (!assignRenderTextures((Texture**)textures, numTextures))
@@ -75,7 +76,7 @@ bool RenderPassDX12::ReinitializeRenderTargetViews(CommandListDX12* commandList,
 												   std::shared_ptr<DX12::DescriptorHeapAllocator> rtDescriptorHeap,
 												   std::shared_ptr<DX12::DescriptorHeapAllocator> dtDescriptorHeap)
 {
-	if (numRenderTarget_ == 0)
+	if (numRenderTarget_ == 0 && !GetHasDepthTexture())
 		return false;
 
 	ID3D12DescriptorHeap* heapRTV = nullptr;
@@ -86,7 +87,7 @@ bool RenderPassDX12::ReinitializeRenderTargetViews(CommandListDX12* commandList,
 	std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 16> cpuDescriptorHandleDSV;
 	std::array<D3D12_GPU_DESCRIPTOR_HANDLE, 16> gpuDescriptorHandleDSV;
 
-	if (!rtDescriptorHeap->Allocate(heapRTV, cpuDescriptorHandleRTV, gpuDescriptorHandleRTV, numRenderTarget_))
+	if (numRenderTarget_ > 0 && !rtDescriptorHeap->Allocate(heapRTV, cpuDescriptorHandleRTV, gpuDescriptorHandleRTV, numRenderTarget_))
 	{
 		return nullptr;
 	}
@@ -144,6 +144,26 @@ enum class ConstantBufferType
 	ShortTime, //! this constant buffer is disposed or rewrite by a frame. If shorttime, this constant buffer must be disposed by a frame.
 };
 
+enum class LockMode
+{
+	Default, //! contents are kept and gpu may read them while they are written
+	Discard, //! contents are discarded and a memory which is not used by gpu is returned
+};
+
+enum class LoadAction
+{
+	Load,	  //! contents are read from memory
+	Clear,	  //! contents are cleared
+	DontCare, //! contents are undefined, it is the fastest when all pixels are overwritten
+};
+
+enum class StoreAction
+{
+	Store,	  //! contents are written to memory
+	DontCare, //! contents are discarded after a render pass
+	Resolve,  //! only a resolved texture is written and multisampled contents are discarded
+};
+
 struct Vec2I
 {
 	int32_t X;
@@ -127,6 +127,31 @@ bool CommandList::BeginWithPlatform(void* platformContextPtr)
 	return true;
 }
 
+bool CommandList::Continue() { return false; }
+
+ReadbackTicket* CommandList::ReadbackTexture(Texture* texture)
+{
+	if (texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	return ReadbackTexture(texture, Vec2I(0, 0), texture->GetSizeAs2D());
+}
+
+void CommandList::ContinueInternal()
+{
+	bindingVertexBuffer.vertexBuffer = nullptr;
+	bindingIndexBuffer.indexBuffer = nullptr;
+	currentPipelineState = nullptr;
+	isVertexBufferDirtied = true;
+	isCurrentIndexBufferDirtied = true;
+	isPipelineDirtied = true;
+	ResetTextures();
+
+	isInBegin_ = true;
+}
+
 void CommandList::End()
 {
 	isInBegin_ = false;
@@ -264,6 +289,12 @@ void CommandList::WaitUntilCompleted()
 	assert(0); // TODO: Not implemented.
 }
 
+bool CommandList::IsCompleted()
+{
+	assert(0); // TODO: Not implemented.
+	return true;
+}
+
 bool CommandList::GetIsInRenderPass() const { return isInRenderPass_; }
 
 } // namespace LLGI
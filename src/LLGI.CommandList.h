@@ -10,6 +10,64 @@ static constexpr int NumTexture = TextureSlotMax;
 class VertexBuffer;
 class IndexBuffer;
 
+/**
+	@brief	a result of CommandList::ReadbackTexture
+	@note
+	Data is available after gpu finishes commands which the readback was recorded in.
+	A ticket may own the last reference of graphics, so its last reference must be released in a thread which executes command lists.
+*/
+class ReadbackTicket : public ReferenceObject
+{
+public:
+	ReadbackTicket() = default;
+	~ReadbackTicket() override = default;
+
+	//! whether gpu finished copying
+	virtual bool IsCompleted() { return false; }
+
+	/**
+		@brief	wait until gpu finishes copying
+		@note
+		It must be called in a thread which executes command lists because commands may be flushed. Use a timed wait in other threads.
+		It fails if a command list is not executed.
+	*/
+	virtual bool Wait() { return false; }
+
+	/**
+		@brief	wait until gpu finishes copying for at most a timeout in milliseconds
+		@note
+		It can be called in any thread because commands are not flushed.
+		It fails soon if a command list is not executed, and fails if commands are not submitted and finished within the timeout.
+	*/
+	virtual bool Wait(int32_t timeoutMilliseconds) { return false; }
+
+	/**
+		@brief	get copied pixels without copying them to cpu memory again
+		@note
+		It returns null until gpu finishes copying. The pointer is valid while the ticket is alive.
+	*/
+	virtual const void* GetData() { return nullptr; }
+
+	//! bytes between rows in GetData
+	virtual int32_t GetRowPitch() const { return 0; }
+
+	virtual Vec2I GetSize() const { return Vec2I(); }
+
+	virtual TextureFormatType GetFormat() const { return TextureFormatType::Unknown; }
+};
+
+/**
+	@brief	statistics of commands which are recorded since CommandList::Begin
+*/
+struct CommandListStatistics
+{
+	//! pipeline barriers which are recorded, barriers which are recorded together are counted as one
+	int32_t PipelineBarrierCount = 0;
+
+	//! transitions of images which are included in pipeline barriers
+	int32_t ImageBarrierCount = 0;
+};
+
 /**
 	@brief	command list
 	@note
@@ -19,6 +77,7 @@ class IndexBuffer;
 
 	Limitation :
 	Begin and End are need to call only once in one frame.
+	To submit a part of commands in a frame earlier, use Continue instead of Begin.
 	Command list must not be released after finishing rendering.
 */
 class CommandList : public ReferenceObject
@@ -79,6 +138,9 @@ protected:
 	void GetCurrentConstantBuffer(ShaderStageType type, ConstantBuffer*& buffer);
 	void RegisterReferencedObject(ReferenceObject* referencedObject);
 
+	//! reset binding states without releasing references in the current frame
+	void ContinueInternal();
+
 public:
 	CommandList(int32_t swapCount = 3);
 	~CommandList() override;
@@ -98,6 +160,16 @@ public:
 	*/
 	virtual bool BeginWithPlatform(void* platformContextPtr);
 
+	/**
+		@brief
+		start to add commands again after End in the same frame.
+		Commands which were added before must be executed with Graphics::Execute before calling it.
+		They can start on gpu with Graphics::Flush while later commands are added.
+		This function can be called several times in one frame.
+		@return	false if it is not supported
+	*/
+	virtual bool Continue();
+
 	virtual void End();
 	virtual void EndWithPlatform();
 
@@ -128,6 +200,26 @@ public:
 	*/
 	virtual void GenerateMipMap(Texture* src) {}
 
+	/**
+		@brief	copy a region of a texture to cpu memory after previous commands in this command list
+		@note
+		It must be called outside of RenderPass.
+		It does not wait for gpu, the result is read from the ticket after the command list is executed.
+		Depth and multisampled textures are not supported.
+		@return	null if it is not supported
+	*/
+	virtual ReadbackTicket* ReadbackTexture(Texture* texture, const Vec2I& position, const Vec2I& size) { return nullptr; }
+
+	//! copy a whole texture
+	ReadbackTicket* ReadbackTexture(Texture* texture);
+
+	/**
+		@brief	get statistics of commands which are recorded since Begin
+		@note
+		This function is supported in some platform.
+	*/
+	virtual CommandListStatistics GetStatistics() const { return CommandListStatistics(); }
+
 	/**
 		@brief	reset textures and set null.
 	*/
@@ -174,6 +266,11 @@ public:
 	*/
 	virtual void WaitUntilCompleted();
 
+	/**
+		@brief	whether this command is completed without waiting.
+	*/
+	virtual bool IsCompleted();
+
 	bool GetIsInRenderPass() const;
 };
 
@@ -8,6 +8,8 @@ void* ConstantBuffer::Lock() { return nullptr; }
 
 void* ConstantBuffer::Lock(int32_t offset, int32_t size) { return nullptr; }
 
+void* ConstantBuffer::Lock(LockMode mode) { return Lock(); }
+
 void ConstantBuffer::Unlock() {}
 
 int32_t ConstantBuffer::GetSize() { return 0; }
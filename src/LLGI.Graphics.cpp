@@ -1,6 +1,9 @@
 #include "LLGI.Graphics.h"
 #include "LLGI.ConstantBuffer.h"
+#include "LLGI.IndexBuffer.h"
 #include "LLGI.Texture.h"
+#include "LLGI.VertexBuffer.h"
+#include <algorithm>
 
 namespace LLGI
 {
@@ -25,6 +28,10 @@ SingleFrameMemoryPool::SingleFrameMemoryPool(int32_t swapBufferCount) : swapBuff
 	{
 		offsets_.push_back(0);
 		constantBuffers_.push_back(std::vector<ConstantBuffer*>());
+		vertexBufferOffsets_.push_back(0);
+		vertexBuffers_.push_back(std::vector<VertexBuffer*>());
+		indexBufferOffsets_.push_back(0);
+		indexBuffers_.push_back(std::vector<IndexBuffer*>());
 	}
 }
 
@@ -37,6 +44,22 @@ SingleFrameMemoryPool::~SingleFrameMemoryPool()
 			c->Release();
 		}
 	}
+
+	for (auto& vertexBuffer : vertexBuffers_)
+	{
+		for (auto v : vertexBuffer)
+		{
+			v->Release();
+		}
+	}
+
+	for (auto& indexBuffer : indexBuffers_)
+	{
+		for (auto i : indexBuffer)
+		{
+			i->Release();
+		}
+	}
 }
 
 void SingleFrameMemoryPool::NewFrame()
@@ -44,40 +67,76 @@ void SingleFrameMemoryPool::NewFrame()
 	currentSwapBuffer_++;
 	currentSwapBuffer_ %= swapBufferCount_;
 	offsets_[currentSwapBuffer_] = 0;
+	vertexBufferOffsets_[currentSwapBuffer_] = 0;
+	indexBufferOffsets_[currentSwapBuffer_] = 0;
 }
 
-ConstantBuffer* SingleFrameMemoryPool::CreateConstantBuffer(int32_t size)
+/**
+	@brief	reuse a buffer which was created in the same swap buffer or create a new buffer
+*/
+template <typename T, typename CreateFunc, typename ReinitializeFunc>
+static T* GetOrCreateBuffer(std::vector<T*>& buffers, int32_t& offset, CreateFunc create, ReinitializeFunc reinitialize)
 {
-	assert(currentSwapBuffer_ >= 0);
-
-	if (static_cast<int32_t>(constantBuffers_[currentSwapBuffer_].size()) <= offsets_[currentSwapBuffer_])
+	if (static_cast<int32_t>(buffers.size()) <= offset)
 	{
-		auto cb = CreateConstantBufferInternal(size);
-		if (cb == nullptr)
+		auto buffer = create();
+		if (buffer == nullptr)
 		{
 			return nullptr;
 		}
 
-		constantBuffers_[currentSwapBuffer_].push_back(cb);
-		SafeAddRef(cb);
-		offsets_[currentSwapBuffer_]++;
-		return cb;
+		buffers.push_back(buffer);
+		SafeAddRef(buffer);
+		offset++;
+		return buffer;
 	}
 	else
 	{
-		auto cb = constantBuffers_[currentSwapBuffer_][offsets_[currentSwapBuffer_]];
-		auto newCb = ReinitializeConstantBuffer(cb, size);
-		if (newCb == nullptr)
+		auto newBuffer = reinitialize(buffers[offset]);
+		if (newBuffer == nullptr)
 		{
 			return nullptr;
 		}
 
-		SafeAddRef(newCb);
-		offsets_[currentSwapBuffer_]++;
-		return newCb;
+		SafeAddRef(newBuffer);
+		offset++;
+		return newBuffer;
 	}
 }
 
+ConstantBuffer* SingleFrameMemoryPool::CreateConstantBuffer(int32_t size)
+{
+	assert(currentSwapBuffer_ >= 0);
+
+	return GetOrCreateBuffer(
+		constantBuffers_[currentSwapBuffer_],
+		offsets_[currentSwapBuffer_],
+		[&]() { return CreateConstantBufferInternal(size); },
+		[&](ConstantBuffer* cb) { return ReinitializeConstantBuffer(cb, size); });
+}
+
+VertexBuffer* SingleFrameMemoryPool::CreateVertexBuffer(int32_t size)
+{
+	assert(currentSwapBuffer_ >= 0);
+
+	return GetOrCreateBuffer(
+		vertexBuffers_[currentSwapBuffer_],
+		vertexBufferOffsets_[currentSwapBuffer_],
+		[&]() { return CreateVertexBufferInternal(size); },
+		[&](VertexBuffer* vb) { return ReinitializeVertexBuffer(vb, size); });
+}
+
+IndexBuffer* SingleFrameMemoryPool::CreateIndexBuffer(int32_t stride, int32_t count)
+{
+	assert(currentSwapBuffer_ >= 0);
+
+	return GetOrCreateBuffer(
+		indexBuffers_[currentSwapBuffer_],
+		indexBufferOffsets_[currentSwapBuffer_],
+		[&]() { return CreateIndexBufferInternal(stride, count); },
+		[&](IndexBuffer* ib) { return ReinitializeIndexBuffer(ib, stride, count); });
+}
+
 bool RenderPass::assignRenderTextures(Texture** textures, int32_t count)
 {
 	for (int32_t i = 0; i < count; i++)
@@ -161,13 +220,14 @@ bool RenderPass::getSize(Vec2I& size,
 						 Texture* resolvedRenderTexture,
 						 Texture* resolvedDepthTexture) const
 {
-	if (textureCount == 0)
+	// a depth only pass
+	if (textureCount == 0 && depthTexture == nullptr)
 	{
 		Log(LogType::Error, "RenderPass : Invalid Count.");
 		return false;
 	}
 
-	size = textures[0]->GetSizeAs2D();
+	size = textureCount > 0 ? textures[0]->GetSizeAs2D() : depthTexture->GetSizeAs2D();
 
 	for (int i = 0; i < textureCount; i++)
 	{
@@ -275,7 +335,8 @@ bool RenderPass::sanitize()
 		}
 	}
 
-	if (depthTexture_ != nullptr && renderTextures_.at(0)->GetSamplingCount() != depthTexture_->GetSamplingCount())
+	if (depthTexture_ != nullptr && renderTextures_.size() > 0 &&
+		renderTextures_.at(0)->GetSamplingCount() != depthTexture_->GetSamplingCount())
 	{
 		Log(LogType::Error, "RenderPass : SamplingCount are not same.");
 		return false;
@@ -284,6 +345,12 @@ bool RenderPass::sanitize()
 	return true;
 }
 
+RenderPass::RenderPass()
+{
+	colorLoadActions_.fill(LoadAction::DontCare);
+	colorStoreActions_.fill(StoreAction::Store);
+}
+
 RenderPass::~RenderPass()
 {
 	SafeRelease(depthTexture_);
@@ -296,13 +363,71 @@ RenderPass::~RenderPass()
 	}
 }
 
-void RenderPass::SetIsColorCleared(bool isColorCleared) { isColorCleared_ = isColorCleared; }
+void RenderPass::SetIsColorCleared(bool isColorCleared)
+{
+	isColorCleared_ = isColorCleared;
+	colorLoadActions_.fill(isColorCleared ? LoadAction::Clear : LoadAction::DontCare);
+}
 
-void RenderPass::SetIsDepthCleared(bool isDepthCleared) { isDepthCleared_ = isDepthCleared; }
+void RenderPass::SetIsDepthCleared(bool isDepthCleared)
+{
+	isDepthCleared_ = isDepthCleared;
+	depthLoadAction_ = isDepthCleared ? LoadAction::Clear : LoadAction::DontCare;
+}
+
+void RenderPass::SetColorLoadAction(int32_t index, LoadAction action)
+{
+	if (index < 0 || index >= RenderTargetMax)
+	{
+		Log(LogType::Error, "RenderPass : Invalid Index.");
+		return;
+	}
+
+	colorLoadActions_[index] = action;
+	isColorCleared_ = std::find(colorLoadActions_.begin(), colorLoadActions_.end(), LoadAction::Clear) != colorLoadActions_.end();
+}
+
+void RenderPass::SetColorStoreAction(int32_t index, StoreAction action)
+{
+	if (index < 0 || index >= RenderTargetMax)
+	{
+		Log(LogType::Error, "RenderPass : Invalid Index.");
+		return;
+	}
+
+	// multisampled contents would be discarded without being resolved
+	if (action == StoreAction::Resolve && (index != 0 || GetResolvedRenderTexture() == nullptr))
+	{
+		Log(LogType::Error, "RenderPass : Resolve requires a resolved render texture.");
+		return;
+	}
+
+	colorStoreActions_[index] = action;
+}
+
+void RenderPass::SetDepthLoadAction(LoadAction action)
+{
+	depthLoadAction_ = action;
+	isDepthCleared_ = action == LoadAction::Clear;
+}
+
+void RenderPass::SetDepthStoreAction(StoreAction action)
+{
+	if (action == StoreAction::Resolve && GetResolvedDepthTexture() == nullptr)
+	{
+		Log(LogType::Error, "RenderPass : Resolve requires a resolved depth texture.");
+		return;
+	}
+
+	depthStoreAction_ = action;
+}
 
 void RenderPass::SetClearColor(const Color8& color) { color_ = color; }
 
-bool RenderPass::GetIsSwapchainScreen() const { return GetRenderTexture(0)->GetType() == TextureType::Screen; }
+bool RenderPass::GetIsSwapchainScreen() const
+{
+	return GetRenderTextureCount() > 0 && GetRenderTexture(0)->GetType() == TextureType::Screen;
+}
 
 RenderPassPipelineStateKey RenderPass::GetKey() const
 {
@@ -312,7 +437,7 @@ RenderPassPipelineStateKey RenderPass::GetKey() const
 	key.IsColorCleared = GetIsColorCleared();
 	key.IsDepthCleared = GetIsDepthCleared();
 	key.RenderTargetFormats.resize(GetRenderTextureCount());
-	key.SamplingCount = renderTextures_.at(0)->GetSamplingCount();
+	key.SamplingCount = renderTextures_.size() > 0 ? renderTextures_.at(0)->GetSamplingCount() : depthTexture_->GetSamplingCount();
 	key.HasResolvedRenderTarget = GetResolvedRenderTexture() != nullptr;
 	key.HasResolvedDepthTarget = GetResolvedDepthTexture() != nullptr;
 
@@ -343,7 +468,18 @@ Graphics::~Graphics()
 
 void Graphics::SetWindowSize(const Vec2I& windowSize) { windowSize_ = windowSize; }
 
-void Graphics::Execute(CommandList* commandList) {}
+SyncPoint Graphics::Execute(CommandList* commandList) { return SyncPoint(); }
+
+bool Graphics::Wait(const SyncPoint& syncPoint)
+{
+	if (syncPoint.IsValid())
+	{
+		WaitFinish();
+	}
+	return true;
+}
+
+bool Graphics::IsCompleted(const SyncPoint& syncPoint) { return !syncPoint.IsValid(); }
 
 // RenderPass* Graphics::GetCurrentScreen(const Color8& clearColor, bool isColorCleared, bool isDepthCleared) { return nullptr; }
 
@@ -3,6 +3,7 @@
 
 #include "LLGI.Base.h"
 #include "Utils/LLGI.FixedSizeVector.h"
+#include <array>
 #include <functional>
 #include <unordered_map>
 
@@ -37,6 +38,81 @@ struct DepthTextureInitializationParameter
 	DepthTextureMode Mode = DepthTextureMode::Depth;
 };
 
+/**
+	@brief	statistics of SingleFrameMemoryPool
+*/
+struct SingleFrameMemoryPoolStatistics
+{
+	//! bytes which are allocated for all frames
+	int64_t ReservedSize = 0;
+
+	//! bytes which were used in the last frame, which include padding for alignment
+	int64_t UsedSize = 0;
+
+	//! bytes which were requested in the last frame, RequestedSize / UsedSize is an efficiency of packing
+	int64_t RequestedSize = 0;
+
+	//! the number of buffers which were allocated in the last frame
+	int32_t AllocationCount = 0;
+
+	//! the largest bytes which were used in a frame
+	int64_t HighWaterMark = 0;
+
+	//! the number of pages which were added because a frame was full
+	int32_t GrowthCount = 0;
+
+	//! the number of times which grown memory was shrunk
+	int32_t ShrinkCount = 0;
+};
+
+/**
+	@brief	statistics of transient render textures which are acquired with Graphics::AcquireTransientRenderTexture
+*/
+struct TransientRenderTexturePoolStatistics
+{
+	//! textures which a pool owns
+	int32_t TextureCount = 0;
+
+	//! textures which are acquired and may be used by gpu
+	int32_t UsedTextureCount = 0;
+
+	//! bytes of textures which a pool owns
+	int64_t MemorySize = 0;
+
+	//! the number of acquisitions
+	int64_t AcquireCount = 0;
+
+	//! the number of acquisitions which reused a texture, ReuseCount / AcquireCount is a reuse rate
+	int64_t ReuseCount = 0;
+
+	//! the number of textures which were released because they were not used
+	int64_t TrimCount = 0;
+};
+
+/**
+	@brief	statistics of framebuffers which are shared among render passes with same attachments
+*/
+struct FramebufferCacheStatistics
+{
+	//! framebuffers which are cached until one of their attachments is destroyed
+	int32_t FramebufferCount = 0;
+
+	//! framebuffers which were evicted and are destroyed after gpu finishes using them
+	int32_t EvictedFramebufferCount = 0;
+};
+
+/**
+	@brief	a point on a timeline of gpu which is returned by Graphics::Execute
+	@note
+	Values increase monotonically. A sync point whose value is 0 is invalid and treated as completed.
+*/
+struct SyncPoint
+{
+	uint64_t Value = 0;
+
+	bool IsValid() const { return Value != 0; }
+};
+
 /**
 	@brief	provide a memory which is available in one frame
 */
@@ -45,8 +121,13 @@ class SingleFrameMemoryPool : public ReferenceObject
 protected:
 	int32_t currentSwapBuffer_ = -1;
 	int32_t swapBufferCount_ = 0;
+	int32_t shrinkFrameCount_ = 0;
 	std::vector<int32_t> offsets_;
 	std::vector<std::vector<ConstantBuffer*>> constantBuffers_;
+	std::vector<int32_t> vertexBufferOffsets_;
+	std::vector<std::vector<VertexBuffer*>> vertexBuffers_;
+	std::vector<int32_t> indexBufferOffsets_;
+	std::vector<std::vector<IndexBuffer*>> indexBuffers_;
 
 	/**
 		@brief	create constant buffer
@@ -58,6 +139,26 @@ protected:
 	*/
 	virtual ConstantBuffer* ReinitializeConstantBuffer(ConstantBuffer* cb, int32_t size) { return nullptr; }
 
+	/**
+		@brief	create vertex buffer
+	*/
+	virtual VertexBuffer* CreateVertexBufferInternal(int32_t size) { return nullptr; }
+
+	/**
+		@brief	reinitialize buffer with a size
+	*/
+	virtual VertexBuffer* ReinitializeVertexBuffer(VertexBuffer* vb, int32_t size) { return nullptr; }
+
+	/**
+		@brief	create index buffer
+	*/
+	virtual IndexBuffer* CreateIndexBufferInternal(int32_t stride, int32_t count) { return nullptr; }
+
+	/**
+		@brief	reinitialize buffer with a stride and count
+	*/
+	virtual IndexBuffer* ReinitializeIndexBuffer(IndexBuffer* ib, int32_t stride, int32_t count) { return nullptr; }
+
 public:
 	SingleFrameMemoryPool(int32_t swapBufferCount = 3);
 	~SingleFrameMemoryPool() override;
@@ -68,14 +169,56 @@ public:
 	virtual void NewFrame();
 
 	virtual ConstantBuffer* CreateConstantBuffer(int32_t size);
+
+	/**
+		@brief	shrink memory which was grown after the specified number of frames in which it is not required
+		@note
+		If it is 0, grown memory is kept.
+	*/
+	void SetShrinkFrameCount(int32_t frameCount) { shrinkFrameCount_ = frameCount; }
+
+	int32_t GetShrinkFrameCount() const { return shrinkFrameCount_; }
+
+	/**
+		@brief	get statistics of the memory
+		@note
+		This function is supported in some platform.
+	*/
+	virtual SingleFrameMemoryPoolStatistics GetStatistics() const { return SingleFrameMemoryPoolStatistics(); }
+
+	/**
+		@brief	create a vertex buffer which is available in the current frame
+		@note
+		It is written without a copy and recycled automatically by NewFrame.
+		It returns nullptr if the platform does not support it.
+	*/
+	virtual VertexBuffer* CreateVertexBuffer(int32_t size);
+
+	/**
+		@brief	create an index buffer which is available in the current frame
+		@note
+		It is written without a copy and recycled automatically by NewFrame.
+		It returns nullptr if the platform does not support it.
+	*/
+	virtual IndexBuffer* CreateIndexBuffer(int32_t stride, int32_t count);
 };
 
+/**
+	@brief	a key of a compatibility class of render passes
+	@note
+	Render passes which differ only in load operations are compatible, so IsColorCleared and IsDepthCleared are not compared.
+	A pipeline state which is created with one of them can be used with all of them.
+*/
 struct RenderPassPipelineStateKey
 {
 	bool IsPresent = false;
 	TextureFormatType DepthFormat = TextureFormatType::Unknown;
 	FixedSizeVector<TextureFormatType, RenderTargetMax> RenderTargetFormats;
+
+	//! a load operation which is used when a render pass is created from this key, it is not compared
 	bool IsColorCleared = true;
+
+	//! a load operation which is used when a render pass is created from this key, it is not compared
 	bool IsDepthCleared = true;
 	bool HasResolvedRenderTarget = false;
 	bool HasResolvedDepthTarget = false;
@@ -92,8 +235,7 @@ struct RenderPassPipelineStateKey
 				return false;
 		}
 
-		return (IsPresent == value.IsPresent && DepthFormat == value.DepthFormat && IsColorCleared == value.IsColorCleared &&
-				IsDepthCleared == value.IsDepthCleared && SamplingCount == value.SamplingCount &&
+		return (IsPresent == value.IsPresent && DepthFormat == value.DepthFormat && SamplingCount == value.SamplingCount &&
 				HasResolvedRenderTarget == value.HasResolvedRenderTarget && HasResolvedDepthTarget == value.HasResolvedDepthTarget);
 	}
 
@@ -105,8 +247,6 @@ struct RenderPassPipelineStateKey
 		{
 			auto ret = std::hash<bool>()(key.IsPresent);
 			ret += std::hash<TextureFormatType>()(key.DepthFormat);
-			ret += std::hash<bool>()(key.IsColorCleared);
-			ret += std::hash<bool>()(key.IsDepthCleared);
 			ret += std::hash<int32_t>()(key.SamplingCount);
 			ret += std::hash<bool>()(key.HasResolvedRenderTarget);
 			ret += std::hash<bool>()(key.HasResolvedDepthTarget);
@@ -130,6 +270,12 @@ private:
 
 	Color8 color_;
 
+	//! contents which are not cleared are undefined unless Load is specified, and all attachments are stored by default
+	std::array<LoadAction, RenderTargetMax> colorLoadActions_;
+	std::array<StoreAction, RenderTargetMax> colorStoreActions_;
+	LoadAction depthLoadAction_ = LoadAction::DontCare;
+	StoreAction depthStoreAction_ = StoreAction::Store;
+
 	FixedSizeVector<Texture*, RenderTargetMax> renderTextures_;
 	Texture* depthTexture_ = nullptr;
 	Texture* resolvedRenderTexture_ = nullptr;
@@ -152,7 +298,7 @@ protected:
 	bool sanitize();
 
 public:
-	RenderPass() = default;
+	RenderPass();
 	~RenderPass() override;
 
 	virtual bool GetIsColorCleared() const { return isColorCleared_; }
@@ -167,6 +313,43 @@ public:
 
 	virtual void SetClearColor(const Color8& color);
 
+	LoadAction GetColorLoadAction(int32_t index) const { return colorLoadActions_.at(index); }
+
+	StoreAction GetColorStoreAction(int32_t index) const { return colorStoreActions_.at(index); }
+
+	LoadAction GetDepthLoadAction() const { return depthLoadAction_; }
+
+	StoreAction GetDepthStoreAction() const { return depthStoreAction_; }
+
+	/**
+		@brief	specify how contents of a render texture are initialized
+		@note
+		It is DontCare by default, so Load must be specified to read contents which were rendered before.
+		SetIsColorCleared overwrites actions of all render textures.
+		GetIsColorCleared returns true if one of render textures is cleared.
+	*/
+	virtual void SetColorLoadAction(int32_t index, LoadAction action);
+
+	/**
+		@brief	specify whether contents of a render texture are written to memory
+		@note
+		Use DontCare or Resolve when a texture is not read after a render pass to reduce a bandwidth.
+		Resolve is rejected without a resolved render texture, which is a target of the first render texture only.
+	*/
+	virtual void SetColorStoreAction(int32_t index, StoreAction action);
+
+	//! it is DontCare by default like a depth which is not cleared
+	virtual void SetDepthLoadAction(LoadAction action);
+
+	/**
+		@brief	specify whether depth is written to memory
+		@note
+		It is Store by default, so depth can be sampled or loaded after a render pass.
+		Use DontCare when depth is used only in a render pass to reduce a bandwidth.
+		Resolve is rejected without a resolved depth texture.
+	*/
+	virtual void SetDepthStoreAction(StoreAction action);
+
 	virtual Texture* GetRenderTexture(int index) const { return renderTextures_.at(index); }
 
 	virtual int GetRenderTextureCount() const { return static_cast<int32_t>(renderTextures_.size()); }
@@ -207,6 +390,7 @@ class Graphics : public ReferenceObject
 protected:
 	Vec2I windowSize_;
 	std::function<void()> disposed_;
+	int32_t transientRenderTextureTrimFrameCount_ = 60;
 
 public:
 	Graphics() = default;
@@ -218,14 +402,40 @@ public:
 		@brief	Execute commands
 		@note
 		Don't release before finish executing commands.
+		@return	a sync point which is completed when the commands are finished. It is invalid in some platform.
 	*/
-	virtual void Execute(CommandList* commandList);
+	virtual SyncPoint Execute(CommandList* commandList);
+
+	/**
+		@brief	submit executed commands to gpu
+		@note
+		Executed commands may be submitted together to reduce a cost of submission. They are submitted in Platform::Present implicitly.
+		This function is required in some platform.
+	*/
+	virtual void Flush() {}
 
 	/**
 	@brief	to prevent instances to be disposed before finish rendering, finish all renderings.
 	*/
 	virtual void WaitFinish() {}
 
+	/**
+		@brief	wait until commands until a sync point are finished
+		@note
+		All commands are waited in a platform which does not support sync points.
+	*/
+	virtual bool Wait(const SyncPoint& syncPoint);
+
+	//! whether commands until a sync point are finished
+	virtual bool IsCompleted(const SyncPoint& syncPoint);
+
+	/**
+		@brief	make commands which are executed after this call wait on gpu until commands until a sync point are finished
+		@note
+		cpu is not blocked.
+	*/
+	virtual void WaitOnGPU(const SyncPoint& syncPoint) {}
+
 	/**
 		@brief	create a vertex buffer
 		@param	size	the size of vertex buffer
@@ -272,6 +482,51 @@ public:
 
 	virtual Texture* CreateDepthTexture(const DepthTextureInitializationParameter& parameter) { return nullptr; }
 
+	/**
+		@brief	get a render texture which is available in the current frame
+		@note
+		A texture is owned by a pool and must not be released.
+		It returns to the pool when gpu finishes the frame, and is reused by an acquisition with the same size, format and sampling count.
+		A frame ends by presenting, WaitFinish or EndTransientRenderTextureFrame, not by Flush.
+		It returns nullptr if the platform does not support it.
+	*/
+	virtual Texture* AcquireTransientRenderTexture(const RenderTextureInitializationParameter& parameter) { return nullptr; }
+
+	/**
+		@brief	end a frame of transient render textures without presenting
+		@note
+		Call it after commands of a frame are executed in a loop which does not present.
+		Textures acquired until now must not be used by commands which are recorded after it.
+	*/
+	virtual void EndTransientRenderTextureFrame() {}
+
+	/**
+		@brief	release transient render textures which are not acquired in the specified number of frames
+		@note
+		Least recently used textures are released first. If it is 0, textures are kept.
+		A frame may be counted by submissions of commands in a platform which does not require presenting.
+	*/
+	void SetTransientRenderTextureTrimFrameCount(int32_t frameCount) { transientRenderTextureTrimFrameCount_ = frameCount; }
+
+	int32_t GetTransientRenderTextureTrimFrameCount() const { return transientRenderTextureTrimFrameCount_; }
+
+	/**
+		@brief	get statistics of transient render textures
+		@note
+		This function is supported in some platform.
+	*/
+	virtual TransientRenderTexturePoolStatistics GetTransientRenderTexturePoolStatistics() const
+	{
+		return TransientRenderTexturePoolStatistics();
+	}
+
+	/**
+		@brief	get statistics of cached framebuffers
+		@note
+		This function is supported in some platform.
+	*/
+	virtual FramebufferCacheStatistics GetFramebufferCacheStatistics() const { return FramebufferCacheStatistics(); }
+
 	/**
 		@brief	create texture from pointer or id in current platform
 	*/
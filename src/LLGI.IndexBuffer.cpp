@@ -8,6 +8,8 @@ void* IndexBuffer::Lock() { return nullptr; }
 
 void* IndexBuffer::Lock(int32_t offset, int32_t size) { return nullptr; }
 
+void* IndexBuffer::Lock(LockMode mode) { return Lock(); }
+
 void IndexBuffer::Unlock() {}
 
 int32_t IndexBuffer::GetStride() { return 0; }
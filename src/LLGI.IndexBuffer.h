@@ -17,6 +17,14 @@ public:
 
 	/*[[deprecated("use CommandList::SetData.")]]*/ virtual void* Lock(int32_t offset, int32_t size);
 
+	/**
+		@brief	lock a whole buffer
+		@note
+		With LockMode::Discard, a buffer which is updated every frame can be written without waiting gpu.
+		Previous contents are lost.
+	*/
+	virtual void* Lock(LockMode mode);
+
 	/*[[deprecated("use CommandList::SetData.")]]*/ virtual void Unlock();
 
 	virtual int32_t GetStride();
@@ -14,6 +14,30 @@ struct PlatformParameter
 {
 	DeviceType Device = DeviceType::Default;
 	bool WaitVSync = true;
+
+	/**
+		@brief	the number of frames which cpu can prepare before gpu finishes them
+		@note
+		Resources for each frame are allocated with this number instead of the number of swap buffers.
+		It is used only in Vulkan now.
+	*/
+	int32_t FrameCount = 2;
+
+	/**
+		@brief	submit commands and present in a dedicated thread
+		@note
+		A frame time on a caller thread does not include a time which a driver spends to submit.
+		It is used only in Vulkan now.
+	*/
+	bool UseSubmissionThread = false;
+
+	/**
+		@brief	begin render passes with dynamic rendering instead of render pass and framebuffer objects
+		@note
+		It requires Vulkan 1.3 and falls back to render pass objects if a driver does not support it.
+		It is used only in Vulkan now.
+	*/
+	bool UseDynamicRendering = false;
 };
 
 Window* CreateWindow(const char* title, Vec2I windowSize);
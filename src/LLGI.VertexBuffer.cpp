@@ -7,6 +7,8 @@ void* VertexBuffer::Lock() { return nullptr; }
 
 void* VertexBuffer::Lock(int32_t offset, int32_t size) { return nullptr; }
 
+void* VertexBuffer::Lock(LockMode mode) { return Lock(); }
+
 void VertexBuffer::Unlock() {}
 
 int32_t VertexBuffer::GetSize() { return 0; }
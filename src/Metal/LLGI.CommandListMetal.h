@@ -39,6 +39,8 @@ public:
 
 	void WaitUntilCompleted() override;
 
+	bool IsCompleted() override;
+
 	bool BeginWithPlatform(void* platformContextPtr) override;
 	void EndWithPlatform() override;
 
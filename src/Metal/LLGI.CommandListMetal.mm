@@ -460,6 +460,18 @@ void CommandListMetal::WaitUntilCompleted()
 	}
 }
 
+bool CommandListMetal::IsCompleted()
+{
+	if (impl->commandBuffer == nullptr)
+	{
+		return true;
+	}
+
+	auto status = [impl->commandBuffer status];
+	return status == MTLCommandBufferStatusNotEnqueued || status == MTLCommandBufferStatusCompleted ||
+		   status == MTLCommandBufferStatusError;
+}
+
 bool CommandListMetal::BeginWithPlatform(void* platformContextPtr) { return CommandList::BeginWithPlatform(platformContextPtr); }
 
 void CommandListMetal::EndWithPlatform() { CommandList::EndWithPlatform(); }
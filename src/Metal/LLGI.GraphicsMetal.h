@@ -43,7 +43,7 @@ public:
 
 	void SetWindowSize(const Vec2I& windowSize) override;
 
-	void Execute(CommandList* commandList) override;
+	SyncPoint Execute(CommandList* commandList) override;
 
 	void WaitFinish() override;
 
@@ -86,7 +86,7 @@ bool GraphicsMetal::Initialize(std::function<GraphicsView()> getGraphicsView)
 
 void GraphicsMetal::SetWindowSize(const Vec2I& windowSize) { throw "Not inplemented"; }
 
-void GraphicsMetal::Execute(CommandList* commandList)
+SyncPoint GraphicsMetal::Execute(CommandList* commandList)
 {
 	// remove finished commands
 	auto it = std::remove_if(executingCommandList_.begin(), executingCommandList_.end(), [](CommandList* cb) {
@@ -107,6 +107,8 @@ void GraphicsMetal::Execute(CommandList* commandList)
 
 	SafeAddRef(commandList);
 	executingCommandList_.push_back(commandList);
+
+	return SyncPoint();
 }
 
 void GraphicsMetal::WaitFinish()
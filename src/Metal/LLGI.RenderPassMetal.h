@@ -33,6 +33,10 @@ public:
 
 	void SetIsDepthCleared(bool isDepthCleared) override;
 
+	void SetColorLoadAction(int32_t index, LoadAction action) override;
+
+	void SetDepthLoadAction(LoadAction action) override;
+
 	void SetClearColor(const Color8& color) override;
 
 	RenderPass_Impl* GetImpl() const;
@@ -172,6 +172,18 @@ void RenderPassMetal::SetIsDepthCleared(bool isDepthCleared)
 	RenderPass::SetIsDepthCleared(isDepthCleared);
 }
 
+void RenderPassMetal::SetColorLoadAction(int32_t index, LoadAction action)
+{
+	RenderPass::SetColorLoadAction(index, action);
+	impl->isColorCleared = GetIsColorCleared();
+}
+
+void RenderPassMetal::SetDepthLoadAction(LoadAction action)
+{
+	RenderPass::SetDepthLoadAction(action);
+	impl->isDepthCleared = GetIsDepthCleared();
+}
+
 void RenderPassMetal::SetClearColor(const Color8& color)
 {
 	impl->clearColor = color;
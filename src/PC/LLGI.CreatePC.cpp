@@ -73,7 +73,8 @@ Platform* CreatePlatform(const PlatformParameter& parameter, Window* window)
 #endif
 	{
 		auto platform = new PlatformVulkan();
-		if (!platform->Initialize(window, parameter.WaitVSync))
+		if (!platform->Initialize(
+				window, parameter.WaitVSync, parameter.FrameCount, parameter.UseSubmissionThread, parameter.UseDynamicRendering))
 		{
 			SafeRelease(platform);
 			return nullptr;
@@ -3,28 +3,62 @@
 
 #include "../LLGI.CommandList.h"
 #include "../LLGI.Graphics.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace LLGI
 {
 
+/**
+	@brief	a pool which reuses command lists after gpu finishes them
+	@note
+	Command lists are reused in the order they were got, so a list which was got recently is not returned until other lists are got.
+	If the oldest list is still used by gpu, a new list is added instead of waiting.
+	This class is not thread safe. Use ThreadCommandListPool to get lists in several threads.
+*/
 class CommandListPool
 {
 private:
 	Graphics* graphics_ = nullptr;
+	SingleFrameMemoryPool* memoryPool_ = nullptr;
+	int32_t maxCount_ = 0;
 
-	int32_t current_ = 0;
-	std::vector<CommandList*> commandLists_;
+	//! lists in the order they were got, the front is the oldest
+	std::deque<CommandList*> commandLists_;
+
+	CommandList* Rotate(bool addRef)
+	{
+		auto commandList = commandLists_.front();
+		commandLists_.pop_front();
+		commandLists_.push_back(commandList);
+
+		if (addRef)
+		{
+			SafeAddRef(commandList);
+		}
+
+		return commandList;
+	}
 
 public:
-	CommandListPool(Graphics* graphics, SingleFrameMemoryPool* memoryPool, int32_t count)
+	/**
+		@param	count	the number of lists which are created at first
+		@param	maxCount	the maximum number of lists which the pool grows to, it does not grow if it is equal to count
+	*/
+	CommandListPool(Graphics* graphics, SingleFrameMemoryPool* memoryPool, int32_t count, int32_t maxCount = 64)
 	{
 		SafeAssign(graphics_, graphics);
-
-		commandLists_.reserve(count);
+		SafeAssign(memoryPool_, memoryPool);
+		maxCount_ = std::max(count, maxCount);
 
 		for (int32_t i = 0; i < count; i++)
 		{
-			auto commandList = graphics_->CreateCommandList(memoryPool);
+			auto commandList = graphics_->CreateCommandList(memoryPool_);
 			commandLists_.push_back(commandList);
 		}
 	}
@@ -36,27 +70,127 @@ public:
 			o->Release();
 		}
 
+		SafeRelease(memoryPool_);
 		SafeRelease(graphics_);
 	}
 
-	CommandList* Get(bool addRef = false)
+	/**
+		@brief	get a list without waiting for gpu
+		@return	null if all lists are used by gpu and the pool cannot grow
+	*/
+	CommandList* TryGet(bool addRef = false)
 	{
-		CommandList* commandList = nullptr;
+		if (!commandLists_.empty() && commandLists_.front()->IsCompleted())
+		{
+			return Rotate(addRef);
+		}
 
-		commandLists_[current_]->WaitUntilCompleted();
+		if (static_cast<int32_t>(commandLists_.size()) >= maxCount_)
+		{
+			return nullptr;
+		}
+
+		auto commandList = graphics_->CreateCommandList(memoryPool_);
+		if (commandList == nullptr)
+		{
+			return nullptr;
+		}
 
-		commandList = commandLists_[current_];
+		commandLists_.push_back(commandList);
 
 		if (addRef)
 		{
 			SafeAddRef(commandList);
 		}
 
-		current_++;
-		current_ %= commandLists_.size();
-
 		return commandList;
 	}
+
+	/**
+		@brief	get a list, wait for gpu only if the pool cannot grow
+	*/
+	CommandList* Get(bool addRef = false)
+	{
+		auto commandList = TryGet(addRef);
+		if (commandList != nullptr)
+		{
+			return commandList;
+		}
+
+		commandLists_.front()->WaitUntilCompleted();
+		return Rotate(addRef);
+	}
+
+	int32_t GetCount() const { return static_cast<int32_t>(commandLists_.size()); }
+};
+
+/**
+	@brief	a pool which has a CommandListPool for each thread
+	@note
+	A thread gets lists from its own pool without locking after the pool is created.
+	Lists must be executed in one thread with Graphics::Execute.
+*/
+class ThreadCommandListPool
+{
+private:
+	Graphics* graphics_ = nullptr;
+	SingleFrameMemoryPool* memoryPool_ = nullptr;
+	int32_t count_ = 0;
+	int32_t maxCount_ = 0;
+	uint64_t id_ = 0;
+
+	std::mutex mutex_;
+	std::unordered_map<std::thread::id, std::shared_ptr<CommandListPool>> pools_;
+
+	static uint64_t GenerateID()
+	{
+		static std::atomic<uint64_t> id{0};
+		return ++id;
+	}
+
+public:
+	ThreadCommandListPool(Graphics* graphics, SingleFrameMemoryPool* memoryPool, int32_t count, int32_t maxCount = 64)
+		: count_(count), maxCount_(maxCount), id_(GenerateID())
+	{
+		SafeAssign(graphics_, graphics);
+		SafeAssign(memoryPool_, memoryPool);
+	}
+
+	~ThreadCommandListPool()
+	{
+		pools_.clear();
+		SafeRelease(memoryPool_);
+		SafeRelease(graphics_);
+	}
+
+	//! get a pool of the current thread
+	CommandListPool* GetPool()
+	{
+		// only a last pool is cached in each thread, so that destroyed pools do not leave entries in threads
+		// an id is used instead of a pointer because an address may be reused by other pool
+		thread_local uint64_t cachedID = 0;
+		thread_local CommandListPool* cachedPool = nullptr;
+
+		if (cachedID == id_)
+		{
+			return cachedPool;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto& pool = pools_[std::this_thread::get_id()];
+		if (pool == nullptr)
+		{
+			pool = std::make_shared<CommandListPool>(graphics_, memoryPool_, count_, maxCount_);
+		}
+
+		cachedID = id_;
+		cachedPool = pool.get();
+		return cachedPool;
+	}
+
+	CommandList* TryGet(bool addRef = false) { return GetPool()->TryGet(addRef); }
+
+	CommandList* Get(bool addRef = false) { return GetPool()->Get(addRef); }
 };
 
 } // namespace LLGI
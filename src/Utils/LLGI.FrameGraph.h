@@ -0,0 +1,875 @@
+
+#pragma once
+
+#include "../LLGI.CommandList.h"
+#include "../LLGI.Graphics.h"
+#include "../LLGI.Texture.h"
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace LLGI
+{
+
+//! a handle of a texture which is used in a frame graph
+struct FrameGraphTexture
+{
+	int32_t Index = -1;
+
+	bool IsValid() const { return Index >= 0; }
+};
+
+/**
+	@brief	statistics of a compiled frame graph
+*/
+struct FrameGraphStatistics
+{
+	int32_t PassCount = 0;
+
+	//! passes which are not executed because their outputs are not used
+	int32_t CulledPassCount = 0;
+
+	//! transient textures which are used by executed passes
+	int32_t TransientTextureCount = 0;
+
+	//! textures which are actually allocated for transient textures
+	int32_t PhysicalTextureCount = 0;
+
+	//! bytes which transient textures require without aliasing
+	int64_t TransientMemorySize = 0;
+
+	//! bytes of textures which are allocated for transient textures
+	int64_t PhysicalMemorySize = 0;
+};
+
+class FrameGraph;
+
+/**
+	@brief	a class to declare textures which a pass reads and writes
+*/
+class FrameGraphPassBuilder
+{
+	friend class FrameGraph;
+
+private:
+	FrameGraph* graph_ = nullptr;
+	int32_t passIndex_ = 0;
+
+	FrameGraphPassBuilder(FrameGraph* graph, int32_t passIndex) : graph_(graph), passIndex_(passIndex) {}
+
+public:
+	/**
+		@brief	create a texture which is valid only in this frame
+		@note
+		Transient textures whose lifetimes do not overlap share one texture.
+	*/
+	FrameGraphTexture CreateTexture(const RenderTextureInitializationParameter& parameter);
+
+	FrameGraphTexture CreateDepthTexture(const DepthTextureInitializationParameter& parameter);
+
+	//! sample or copy a texture in this pass
+	void Read(FrameGraphTexture texture);
+
+	//! write a texture outside of a render pass, for example with CopyTexture
+	void Write(FrameGraphTexture texture);
+
+	/**
+		@brief	render into a texture as a next color attachment
+		@note
+		Contents before this pass are required only if loadAction is Load.
+	*/
+	void WriteColor(FrameGraphTexture texture, LoadAction loadAction = LoadAction::DontCare);
+
+	void WriteDepth(FrameGraphTexture texture, LoadAction loadAction = LoadAction::Clear);
+
+	void SetClearColor(const Color8& color);
+
+	//! a pass which has a side effect like readbacks is not culled
+	void SetHasSideEffect();
+};
+
+/**
+	@brief	a class which is passed to a pass when it is executed
+*/
+class FrameGraphPassContext
+{
+	friend class FrameGraph;
+
+private:
+	CommandList* commandList_ = nullptr;
+	RenderPass* renderPass_ = nullptr;
+	const std::vector<Texture*>* textures_ = nullptr;
+
+public:
+	CommandList* GetCommandList() const { return commandList_; }
+
+	//! a render pass which is begun for attachments of this pass, null if the pass has no attachments
+	RenderPass* GetRenderPass() const { return renderPass_; }
+
+	Texture* GetTexture(FrameGraphTexture texture) const { return texture.IsValid() ? textures_->at(texture.Index) : nullptr; }
+};
+
+/**
+	@brief	a graph of passes which are declared every frame
+	@note
+	Passes are executed in an order they were added, and a pass depends on passes which were added before it.
+	Compile fails if a pass reads a transient texture which only a pass added after it writes, because the graph does not reorder passes.
+	The graph inserts no barriers, so resources are transitioned by backends when they are used.
+	Passes whose outputs are not used by other passes or imported textures are culled.
+	Load and store actions of attachments are decided from following passes, so that contents which are not used are discarded
+	and backends transition attachments without preserving them.
+	Transient textures are assigned to textures which the graph owns, and transient textures whose lifetimes do not overlap share one.
+	The graph is not thread safe.
+*/
+class FrameGraph
+{
+	friend class FrameGraphPassBuilder;
+
+private:
+	struct TextureKey
+	{
+		Vec2I Size;
+		TextureFormatType Format = TextureFormatType::Unknown;
+		int32_t SamplingCount = 1;
+		bool IsDepth = false;
+		DepthTextureMode Mode = DepthTextureMode::Depth;
+
+		bool operator==(const TextureKey& o) const
+		{
+			return Size == o.Size && Format == o.Format && SamplingCount == o.SamplingCount && IsDepth == o.IsDepth && Mode == o.Mode;
+		}
+	};
+
+	struct Resource
+	{
+		bool IsImported = false;
+		TextureKey Key;
+		Texture* Imported = nullptr;
+
+		//! an index of executed passes which use it first and last
+		int32_t FirstUse = -1;
+		int32_t LastUse = -1;
+	};
+
+	struct Attachment
+	{
+		int32_t Index = -1;
+		LoadAction Load = LoadAction::DontCare;
+		StoreAction Store = StoreAction::Store;
+	};
+
+	struct Pass
+	{
+		std::string Name;
+		std::vector<int32_t> Reads;
+		std::vector<int32_t> Writes;
+		std::vector<Attachment> Colors;
+		Attachment Depth;
+		Color8 ClearColor;
+		bool HasSideEffect = false;
+		bool IsCulled = false;
+		std::function<void(FrameGraphPassContext&)> Execute;
+	};
+
+	//! a texture which the graph owns for transient textures
+	struct PhysicalTexture
+	{
+		TextureKey Key;
+		Texture* Instance = nullptr;
+
+		//! an index of executed passes after which it can be reused in a current frame
+		int32_t AvailableFrom = 0;
+		int64_t LastUsedFrame = 0;
+	};
+
+	struct CachedRenderPass
+	{
+		RenderPass* Pass = nullptr;
+		int64_t LastUsedFrame = 0;
+	};
+
+	//! a cached render pass is never changed, so actions and a clear color are a part of a key
+	struct RenderPassKey
+	{
+		std::vector<Texture*> Textures;
+		std::vector<int32_t> Actions;
+
+		bool operator<(const RenderPassKey& o) const
+		{
+			if (Textures != o.Textures)
+			{
+				return Textures < o.Textures;
+			}
+			return Actions < o.Actions;
+		}
+	};
+
+	Graphics* graphics_ = nullptr;
+	int64_t frame_ = 0;
+	int32_t shrinkFrameCount_ = 3;
+	bool isCompiled_ = false;
+
+	std::vector<Resource> resources_;
+	std::vector<Pass> passes_;
+	std::vector<int32_t> executedPasses_;
+
+	//! textures which are assigned to resources
+	std::vector<Texture*> textures_;
+
+	std::vector<PhysicalTexture> physicalTextures_;
+
+	//! render passes are reused while the same textures and actions are assigned to attachments
+	std::map<RenderPassKey, CachedRenderPass> renderPasses_;
+
+	FrameGraphStatistics statistics_;
+
+	static int64_t GetMemorySize(const TextureKey& key)
+	{
+		const auto pixelSize = key.IsDepth ? static_cast<int64_t>(key.Size.X) * key.Size.Y * 4 : GetTextureMemorySize(key.Format, key.Size);
+		return pixelSize * key.SamplingCount;
+	}
+
+	int32_t AddResource(const TextureKey& key)
+	{
+		Resource resource;
+		resource.Key = key;
+		resources_.push_back(resource);
+		return static_cast<int32_t>(resources_.size()) - 1;
+	}
+
+	bool IsValid(FrameGraphTexture texture) const
+	{
+		if (texture.Index < 0 || texture.Index >= static_cast<int32_t>(resources_.size()))
+		{
+			Log(LogType::Error, "FrameGraph : An invalid texture is used.");
+			return false;
+		}
+		return true;
+	}
+
+	//! reject a pass which reads a transient texture before a pass which writes it, because passes are not reordered
+	bool Validate() const
+	{
+		const auto passCount = static_cast<int32_t>(passes_.size());
+		std::vector<int32_t> firstWrites(resources_.size(), passCount);
+
+		for (int32_t i = passCount - 1; i >= 0; i--)
+		{
+			const auto& pass = passes_[i];
+			for (auto w : pass.Writes)
+			{
+				firstWrites[w] = i;
+			}
+			for (const auto& c : pass.Colors)
+			{
+				firstWrites[c.Index] = i;
+			}
+			if (pass.Depth.Index >= 0)
+			{
+				firstWrites[pass.Depth.Index] = i;
+			}
+		}
+
+		for (int32_t i = 0; i < passCount; i++)
+		{
+			const auto& pass = passes_[i];
+
+			auto isWrittenBefore = [&](int32_t index) -> bool { return resources_[index].IsImported || firstWrites[index] < i; };
+
+			// contents which are loaded into an attachment are undefined only if it is written first by this pass
+			auto isLoadedBeforeWritten = [&](const Attachment& a) -> bool {
+				return a.Index >= 0 && a.Load == LoadAction::Load && !resources_[a.Index].IsImported && firstWrites[a.Index] > i &&
+					   firstWrites[a.Index] < passCount;
+			};
+
+			bool isValid = true;
+			for (auto r : pass.Reads)
+			{
+				isValid &= isWrittenBefore(r);
+			}
+			for (const auto& c : pass.Colors)
+			{
+				isValid &= !isLoadedBeforeWritten(c);
+			}
+			isValid &= !isLoadedBeforeWritten(pass.Depth);
+
+			if (!isValid)
+			{
+				Log(LogType::Error, "FrameGraph : " + pass.Name + " reads a transient texture before a pass which writes it.");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//! decide which passes are executed from the last pass, with contents which are required after each pass
+	void Cull()
+	{
+		std::vector<bool> isRequired(resources_.size(), false);
+		for (size_t i = 0; i < resources_.size(); i++)
+		{
+			isRequired[i] = resources_[i].IsImported;
+		}
+
+		for (auto it = passes_.rbegin(); it != passes_.rend(); ++it)
+		{
+			auto& pass = *it;
+
+			bool isUsed = pass.HasSideEffect;
+			for (auto w : pass.Writes)
+			{
+				isUsed |= isRequired[w];
+			}
+			for (const auto& c : pass.Colors)
+			{
+				isUsed |= isRequired[c.Index];
+			}
+			if (pass.Depth.Index >= 0)
+			{
+				isUsed |= isRequired[pass.Depth.Index];
+			}
+
+			pass.IsCulled = !isUsed;
+			if (pass.IsCulled)
+			{
+				continue;
+			}
+
+			// contents which are not read after this pass are not stored
+			auto updateAttachment = [&](Attachment& a) -> void {
+				a.Store = isRequired[a.Index] ? StoreAction::Store : StoreAction::DontCare;
+				isRequired[a.Index] = a.Load == LoadAction::Load;
+			};
+
+			for (auto& c : pass.Colors)
+			{
+				updateAttachment(c);
+			}
+			if (pass.Depth.Index >= 0)
+			{
+				updateAttachment(pass.Depth);
+			}
+
+			// a write outside of a render pass may not overwrite all contents
+			for (auto w : pass.Writes)
+			{
+				isRequired[w] = true;
+			}
+
+			for (auto r : pass.Reads)
+			{
+				isRequired[r] = true;
+			}
+		}
+
+		executedPasses_.clear();
+		for (size_t i = 0; i < passes_.size(); i++)
+		{
+			if (!passes_[i].IsCulled)
+			{
+				executedPasses_.push_back(static_cast<int32_t>(i));
+			}
+		}
+	}
+
+	//! compute lifetimes of textures and discard contents which are not written yet
+	void ComputeLifetimes()
+	{
+		std::vector<bool> isWritten(resources_.size(), false);
+
+		for (int32_t order = 0; order < static_cast<int32_t>(executedPasses_.size()); order++)
+		{
+			auto& pass = passes_[executedPasses_[order]];
+
+			auto use = [&](int32_t index) -> void {
+				auto& resource = resources_[index];
+				if (resource.FirstUse < 0)
+				{
+					resource.FirstUse = order;
+				}
+				resource.LastUse = order;
+			};
+
+			auto updateAttachment = [&](Attachment& a) -> void {
+				use(a.Index);
+
+				// a transient texture has no contents before it is written
+				if (a.Load == LoadAction::Load && !resources_[a.Index].IsImported && !isWritten[a.Index])
+				{
+					a.Load = LoadAction::DontCare;
+				}
+				isWritten[a.Index] = true;
+			};
+
+			for (auto r : pass.Reads)
+			{
+				use(r);
+			}
+
+			for (auto w : pass.Writes)
+			{
+				use(w);
+				isWritten[w] = true;
+			}
+
+			for (auto& c : pass.Colors)
+			{
+				updateAttachment(c);
+			}
+
+			if (pass.Depth.Index >= 0)
+			{
+				updateAttachment(pass.Depth);
+			}
+		}
+	}
+
+	Texture* CreatePhysicalTexture(const TextureKey& key)
+	{
+		if (key.IsDepth)
+		{
+			DepthTextureInitializationParameter parameter;
+			parameter.Size = key.Size;
+			parameter.SamplingCount = key.SamplingCount;
+			parameter.Mode = key.Mode;
+			return graphics_->CreateDepthTexture(parameter);
+		}
+
+		RenderTextureInitializationParameter parameter;
+		parameter.Size = key.Size;
+		parameter.Format = key.Format;
+		parameter.SamplingCount = key.SamplingCount;
+		return graphics_->CreateRenderTexture(parameter);
+	}
+
+	//! assign textures to transient textures in an order of first uses
+	bool Allocate()
+	{
+		std::vector<int32_t> transients;
+		for (size_t i = 0; i < resources_.size(); i++)
+		{
+			if (!resources_[i].IsImported && resources_[i].FirstUse >= 0)
+			{
+				transients.push_back(static_cast<int32_t>(i));
+			}
+		}
+
+		std::stable_sort(transients.begin(), transients.end(), [this](int32_t a, int32_t b) -> bool {
+			return resources_[a].FirstUse < resources_[b].FirstUse;
+		});
+
+		for (auto& physical : physicalTextures_)
+		{
+			physical.AvailableFrom = 0;
+		}
+
+		for (auto index : transients)
+		{
+			auto& resource = resources_[index];
+
+			PhysicalTexture* found = nullptr;
+			for (auto& physical : physicalTextures_)
+			{
+				if (physical.Key == resource.Key && physical.AvailableFrom <= resource.FirstUse)
+				{
+					found = &physical;
+					break;
+				}
+			}
+
+			if (found == nullptr)
+			{
+				PhysicalTexture physical;
+				physical.Key = resource.Key;
+				physical.Instance = CreatePhysicalTexture(resource.Key);
+				if (physical.Instance == nullptr)
+				{
+					Log(LogType::Error, "FrameGraph : Failed to create a transient texture.");
+					return false;
+				}
+				physicalTextures_.push_back(physical);
+				found = &physicalTextures_.back();
+			}
+
+			found->AvailableFrom = resource.LastUse + 1;
+			found->LastUsedFrame = frame_;
+			textures_[index] = found->Instance;
+
+			statistics_.TransientTextureCount++;
+			statistics_.TransientMemorySize += GetMemorySize(resource.Key);
+		}
+
+		for (const auto& physical : physicalTextures_)
+		{
+			if (physical.LastUsedFrame == frame_)
+			{
+				statistics_.PhysicalTextureCount++;
+				statistics_.PhysicalMemorySize += GetMemorySize(physical.Key);
+			}
+		}
+
+		return true;
+	}
+
+	//! release textures and render passes which have not been used for a while, gpu has finished them
+	void Shrink()
+	{
+		bool isReleased = false;
+		for (auto it = physicalTextures_.begin(); it != physicalTextures_.end();)
+		{
+			if (frame_ - it->LastUsedFrame > shrinkFrameCount_)
+			{
+				it->Instance->Release();
+				it = physicalTextures_.erase(it);
+				isReleased = true;
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		for (auto it = renderPasses_.begin(); it != renderPasses_.end();)
+		{
+			// render passes refer textures, so they are released to free released textures actually
+			if (isReleased || frame_ - it->second.LastUsedFrame > shrinkFrameCount_)
+			{
+				it->second.Pass->Release();
+				it = renderPasses_.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	RenderPass* GetRenderPass(const Pass& pass)
+	{
+		RenderPassKey key;
+		std::array<Texture*, RenderTargetMax> colors = {};
+		for (size_t i = 0; i < pass.Colors.size(); i++)
+		{
+			colors[i] = textures_[pass.Colors[i].Index];
+			key.Textures.push_back(colors[i]);
+			key.Actions.push_back(static_cast<int32_t>(pass.Colors[i].Load));
+			key.Actions.push_back(static_cast<int32_t>(pass.Colors[i].Store));
+		}
+
+		Texture* depth = pass.Depth.Index >= 0 ? textures_[pass.Depth.Index] : nullptr;
+		key.Textures.push_back(depth);
+		if (depth != nullptr)
+		{
+			key.Actions.push_back(static_cast<int32_t>(pass.Depth.Load));
+			key.Actions.push_back(static_cast<int32_t>(pass.Depth.Store));
+		}
+
+		if (!pass.Colors.empty())
+		{
+			key.Actions.push_back(pass.ClearColor.R | (pass.ClearColor.G << 8) | (pass.ClearColor.B << 16) | (pass.ClearColor.A << 24));
+		}
+
+		auto it = renderPasses_.find(key);
+		if (it != renderPasses_.end())
+		{
+			it->second.LastUsedFrame = frame_;
+			return it->second.Pass;
+		}
+
+		CachedRenderPass cached;
+		cached.Pass = graphics_->CreateRenderPass(colors.data(), static_cast<int32_t>(pass.Colors.size()), depth);
+		cached.LastUsedFrame = frame_;
+		if (cached.Pass == nullptr)
+		{
+			return nullptr;
+		}
+
+		cached.Pass->SetClearColor(pass.ClearColor);
+		for (size_t i = 0; i < pass.Colors.size(); i++)
+		{
+			cached.Pass->SetColorLoadAction(static_cast<int32_t>(i), pass.Colors[i].Load);
+			cached.Pass->SetColorStoreAction(static_cast<int32_t>(i), pass.Colors[i].Store);
+		}
+
+		if (depth != nullptr)
+		{
+			cached.Pass->SetDepthLoadAction(pass.Depth.Load);
+			cached.Pass->SetDepthStoreAction(pass.Depth.Store);
+		}
+
+		renderPasses_[key] = cached;
+		return cached.Pass;
+	}
+
+	void ReleaseImported()
+	{
+		for (auto& resource : resources_)
+		{
+			SafeRelease(resource.Imported);
+		}
+	}
+
+public:
+	FrameGraph(Graphics* graphics) { SafeAssign(graphics_, graphics); }
+
+	~FrameGraph()
+	{
+		ReleaseImported();
+
+		for (auto& cached : renderPasses_)
+		{
+			cached.second.Pass->Release();
+		}
+		renderPasses_.clear();
+
+		for (auto& physical : physicalTextures_)
+		{
+			physical.Instance->Release();
+		}
+		physicalTextures_.clear();
+
+		SafeRelease(graphics_);
+	}
+
+	FrameGraph(const FrameGraph&) = delete;
+	FrameGraph& operator=(const FrameGraph&) = delete;
+
+	/**
+		@brief	the number of frames after which textures and render passes which are not used are released
+		@note
+		It must be larger than the number of frames which gpu processes at once.
+	*/
+	void SetShrinkFrameCount(int32_t frameCount) { shrinkFrameCount_ = frameCount; }
+
+	/**
+		@brief	use a texture which the graph does not own, such as a screen
+		@note
+		Passes which write it are not culled.
+	*/
+	FrameGraphTexture ImportTexture(Texture* texture)
+	{
+		TextureKey key;
+		key.Size = texture->GetSizeAs2D();
+		key.Format = texture->GetFormat();
+		key.SamplingCount = texture->GetSamplingCount();
+		key.IsDepth = texture->GetType() == TextureType::Depth;
+
+		FrameGraphTexture ret;
+		ret.Index = AddResource(key);
+		resources_[ret.Index].IsImported = true;
+		SafeAssign(resources_[ret.Index].Imported, texture);
+		isCompiled_ = false;
+		return ret;
+	}
+
+	/**
+		@brief	add a pass
+		@param	setup	it is called immediately to declare textures
+		@param	execute	it is called in Execute if the pass is not culled
+	*/
+	void AddPass(const std::string& name,
+				 const std::function<void(FrameGraphPassBuilder&)>& setup,
+				 const std::function<void(FrameGraphPassContext&)>& execute)
+	{
+		Pass pass;
+		pass.Name = name;
+		pass.Execute = execute;
+		passes_.push_back(pass);
+
+		FrameGraphPassBuilder builder(this, static_cast<int32_t>(passes_.size()) - 1);
+		setup(builder);
+		isCompiled_ = false;
+	}
+
+	/**
+		@brief	cull passes, decide actions of attachments and assign textures to transient textures
+		@note
+		It fails if a pass reads a transient texture which is written only by passes added after it.
+	*/
+	bool Compile()
+	{
+		statistics_ = FrameGraphStatistics();
+		textures_.assign(resources_.size(), nullptr);
+
+		for (size_t i = 0; i < resources_.size(); i++)
+		{
+			resources_[i].FirstUse = -1;
+			resources_[i].LastUse = -1;
+			textures_[i] = resources_[i].Imported;
+		}
+
+		if (!Validate())
+		{
+			return false;
+		}
+
+		Cull();
+		ComputeLifetimes();
+		Shrink();
+
+		if (!Allocate())
+		{
+			return false;
+		}
+
+		statistics_.PassCount = static_cast<int32_t>(passes_.size());
+		statistics_.CulledPassCount = static_cast<int32_t>(passes_.size() - executedPasses_.size());
+		isCompiled_ = true;
+		return true;
+	}
+
+	//! record passes which are not culled
+	void Execute(CommandList* commandList)
+	{
+		if (!isCompiled_)
+		{
+			Log(LogType::Error, "FrameGraph : Please call Compile before Execute.");
+			return;
+		}
+
+		FrameGraphPassContext context;
+		context.commandList_ = commandList;
+		context.textures_ = &textures_;
+
+		for (auto index : executedPasses_)
+		{
+			const auto& pass = passes_[index];
+			context.renderPass_ = nullptr;
+
+			if (!pass.Colors.empty() || pass.Depth.Index >= 0)
+			{
+				auto renderPass = GetRenderPass(pass);
+				if (renderPass == nullptr)
+				{
+					Log(LogType::Error, "FrameGraph : Failed to create a render pass for " + pass.Name + ".");
+					continue;
+				}
+
+				context.renderPass_ = renderPass;
+				commandList->BeginRenderPass(renderPass);
+			}
+
+			if (pass.Execute != nullptr)
+			{
+				pass.Execute(context);
+			}
+
+			if (context.renderPass_ != nullptr)
+			{
+				commandList->EndRenderPass();
+			}
+		}
+	}
+
+	/**
+		@brief	remove passes and textures to declare a next frame
+		@note
+		Textures which are assigned to transient textures are kept to be reused.
+	*/
+	void Reset()
+	{
+		ReleaseImported();
+		resources_.clear();
+		passes_.clear();
+		executedPasses_.clear();
+		textures_.clear();
+		isCompiled_ = false;
+		frame_++;
+	}
+
+	//! whether a pass is culled in Compile
+	bool GetIsCulled(const std::string& name) const
+	{
+		for (const auto& pass : passes_)
+		{
+			if (pass.Name == name)
+			{
+				return pass.IsCulled;
+			}
+		}
+		return false;
+	}
+
+	const FrameGraphStatistics& GetStatistics() const { return statistics_; }
+};
+
+inline FrameGraphTexture FrameGraphPassBuilder::CreateTexture(const RenderTextureInitializationParameter& parameter)
+{
+	FrameGraph::TextureKey key;
+	key.Size = parameter.Size;
+	key.Format = parameter.Format;
+	key.SamplingCount = parameter.SamplingCount;
+
+	FrameGraphTexture ret;
+	ret.Index = graph_->AddResource(key);
+	return ret;
+}
+
+inline FrameGraphTexture FrameGraphPassBuilder::CreateDepthTexture(const DepthTextureInitializationParameter& parameter)
+{
+	FrameGraph::TextureKey key;
+	key.Size = parameter.Size;
+	key.SamplingCount = parameter.SamplingCount;
+	key.IsDepth = true;
+	key.Mode = parameter.Mode;
+
+	FrameGraphTexture ret;
+	ret.Index = graph_->AddResource(key);
+	return ret;
+}
+
+inline void FrameGraphPassBuilder::Read(FrameGraphTexture texture)
+{
+	if (graph_->IsValid(texture))
+	{
+		graph_->passes_[passIndex_].Reads.push_back(texture.Index);
+	}
+}
+
+inline void FrameGraphPassBuilder::Write(FrameGraphTexture texture)
+{
+	if (graph_->IsValid(texture))
+	{
+		graph_->passes_[passIndex_].Writes.push_back(texture.Index);
+	}
+}
+
+inline void FrameGraphPassBuilder::WriteColor(FrameGraphTexture texture, LoadAction loadAction)
+{
+	auto& pass = graph_->passes_[passIndex_];
+	if (!graph_->IsValid(texture))
+	{
+		return;
+	}
+
+	if (pass.Colors.size() >= RenderTargetMax)
+	{
+		Log(LogType::Error, "FrameGraph : Too many color attachments in " + pass.Name + ".");
+		return;
+	}
+
+	FrameGraph::Attachment attachment;
+	attachment.Index = texture.Index;
+	attachment.Load = loadAction;
+	pass.Colors.push_back(attachment);
+}
+
+inline void FrameGraphPassBuilder::WriteDepth(FrameGraphTexture texture, LoadAction loadAction)
+{
+	if (graph_->IsValid(texture))
+	{
+		auto& depth = graph_->passes_[passIndex_].Depth;
+		depth.Index = texture.Index;
+		depth.Load = loadAction;
+	}
+}
+
+inline void FrameGraphPassBuilder::SetClearColor(const Color8& color) { graph_->passes_[passIndex_].ClearColor = color; }
+
+inline void FrameGraphPassBuilder::SetHasSideEffect() { graph_->passes_[passIndex_].HasSideEffect = true; }
+
+} // namespace LLGI
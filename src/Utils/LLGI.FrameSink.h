@@ -0,0 +1,595 @@
+
+#pragma once
+
+#include "../LLGI.Base.h"
+#include "../LLGI.CommandList.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LLGI
+{
+
+enum class FrameSinkFormatType
+{
+	//! RGBA8 without a header
+	Raw,
+
+	//! binary PPM (P6), alpha is removed
+	PPM,
+
+	//! PNG with uncompressed deflate blocks
+	PNG,
+};
+
+enum class FrameSinkOutputType
+{
+	//! a file for each frame
+	Files,
+
+	//! a stream like a pipe or stdout, frames are written in order
+	Stream,
+
+	//! a function which receives encoded frames in order
+	Callback,
+};
+
+struct FrameSinkParameter
+{
+	FrameSinkFormatType Format = FrameSinkFormatType::PNG;
+	FrameSinkOutputType Output = FrameSinkOutputType::Files;
+
+	//! a path with a printf format of a frame index like "frame_%05d.png", for Files
+	std::string PathFormat = "frame_%05d.png";
+
+	//! a destination for Stream, it is not closed by a sink
+	FILE* Stream = nullptr;
+
+	//! a destination for Callback, it is called in worker threads one by one
+	std::function<void(int64_t index, const std::vector<uint8_t>& data)> Callback;
+
+	int32_t WorkerCount = 2;
+
+	//! the number of frames which wait for workers before Submit blocks or drops
+	int32_t MaxQueuedFrameCount = 8;
+
+	//! whether Submit drops frames instead of waiting when workers are behind
+	bool DropWhenFull = false;
+
+	//! a time in milliseconds which a worker waits for gpu to finish copying a ticket before a frame fails
+	int32_t ReadbackTimeoutMilliseconds = 5000;
+};
+
+/**
+	@brief	a sink which converts, encodes and writes captured frames in worker threads
+	@note
+	Frames are accepted as cpu memory or as ReadbackTicket, so a caller does not wait for gpu or encoding.
+	When MaxQueuedFrameCount frames are waiting, Submit blocks or drops a frame.
+	Submit must be called in one thread, which also releases tickets after workers finish them.
+*/
+class FrameSink
+{
+private:
+	struct Job
+	{
+		int64_t Index = 0;
+		std::vector<uint8_t> Data;
+		ReadbackTicket* Ticket = nullptr;
+		Vec2I Size;
+		int32_t RowPitch = 0;
+		TextureFormatType Format = TextureFormatType::Unknown;
+	};
+
+	FrameSinkParameter parameter_;
+
+	std::mutex mutex_;
+	std::condition_variable jobAdded_;
+	std::condition_variable jobRemoved_;
+	std::deque<Job> jobs_;
+	int64_t submittedCount_ = 0;
+	int64_t finishedCount_ = 0;
+	int64_t droppedCount_ = 0;
+	int64_t failedCount_ = 0;
+	bool isExiting_ = false;
+
+	//! frames are written in order for Stream and Callback
+	std::mutex writeMutex_;
+	std::condition_variable written_;
+	int64_t nextWriteIndex_ = 0;
+
+	std::vector<std::thread> workers_;
+
+	//! tickets which workers finished, they are released in a thread which submits frames
+	std::mutex releaseMutex_;
+	std::vector<ReadbackTicket*> finishedTickets_;
+
+	//! a ticket may own the last reference of graphics, so it is not released in workers
+	void ReturnTicket(Job& job)
+	{
+		if (job.Ticket == nullptr)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(releaseMutex_);
+		finishedTickets_.push_back(job.Ticket);
+		job.Ticket = nullptr;
+	}
+
+	void ReleaseFinishedTickets()
+	{
+		std::vector<ReadbackTicket*> tickets;
+
+		{
+			std::lock_guard<std::mutex> lock(releaseMutex_);
+			tickets.swap(finishedTickets_);
+		}
+
+		for (auto ticket : tickets)
+		{
+			SafeRelease(ticket);
+		}
+	}
+
+	static void WriteUInt32BE(std::vector<uint8_t>& dst, uint32_t value)
+	{
+		dst.push_back(static_cast<uint8_t>(value >> 24));
+		dst.push_back(static_cast<uint8_t>(value >> 16));
+		dst.push_back(static_cast<uint8_t>(value >> 8));
+		dst.push_back(static_cast<uint8_t>(value));
+	}
+
+	static uint32_t CalcCRC32(const uint8_t* data, size_t size, uint32_t crc)
+	{
+		static const std::array<uint32_t, 256> table = []() -> std::array<uint32_t, 256> {
+			std::array<uint32_t, 256> t;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t c = i;
+				for (int32_t k = 0; k < 8; k++)
+				{
+					c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+				}
+				t[i] = c;
+			}
+			return t;
+		}();
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	static void WritePNGChunk(std::vector<uint8_t>& dst, const char* type, const std::vector<uint8_t>& data)
+	{
+		WriteUInt32BE(dst, static_cast<uint32_t>(data.size()));
+		const auto offset = dst.size();
+		dst.insert(dst.end(), type, type + 4);
+		dst.insert(dst.end(), data.begin(), data.end());
+		WriteUInt32BE(dst, CalcCRC32(dst.data() + offset, dst.size() - offset, 0));
+	}
+
+	/**
+		@brief	encode RGBA8 as PNG
+		@note
+		Deflate blocks are not compressed because encoding time matters more than a file size in this sink.
+	*/
+	static std::vector<uint8_t> EncodePNG(const std::vector<uint8_t>& rgba, const Vec2I& size)
+	{
+		const size_t rowSize = static_cast<size_t>(size.X) * 4 + 1;
+
+		// zlib stream which consists of stored blocks
+		std::vector<uint8_t> idat;
+		const size_t rawSize = rowSize * size.Y;
+		idat.reserve(rawSize + rawSize / 65535 * 5 + 16);
+		idat.push_back(0x78);
+		idat.push_back(0x01);
+
+		uint32_t adlerA = 1;
+		uint32_t adlerB = 0;
+		size_t blockRemain = 0;
+		size_t remain = rawSize;
+
+		auto push = [&](uint8_t value) -> void {
+			if (blockRemain == 0)
+			{
+				blockRemain = std::min(remain, static_cast<size_t>(65535));
+				remain -= blockRemain;
+				const auto len = static_cast<uint16_t>(blockRemain);
+				const auto nlen = static_cast<uint16_t>(~len);
+				idat.push_back(remain == 0 ? 1 : 0);
+				idat.push_back(static_cast<uint8_t>(len));
+				idat.push_back(static_cast<uint8_t>(len >> 8));
+				idat.push_back(static_cast<uint8_t>(nlen));
+				idat.push_back(static_cast<uint8_t>(nlen >> 8));
+			}
+
+			idat.push_back(value);
+			blockRemain--;
+			adlerA = (adlerA + value) % 65521;
+			adlerB = (adlerB + adlerA) % 65521;
+		};
+
+		for (int32_t y = 0; y < size.Y; y++)
+		{
+			// filter type none
+			push(0);
+
+			const auto row = rgba.data() + static_cast<size_t>(y) * size.X * 4;
+			for (int32_t x = 0; x < size.X * 4; x++)
+			{
+				push(row[x]);
+			}
+		}
+
+		WriteUInt32BE(idat, (adlerB << 16) | adlerA);
+
+		std::vector<uint8_t> ihdr;
+		WriteUInt32BE(ihdr, static_cast<uint32_t>(size.X));
+		WriteUInt32BE(ihdr, static_cast<uint32_t>(size.Y));
+		ihdr.push_back(8); // bit depth
+		ihdr.push_back(6); // RGBA
+		ihdr.push_back(0);
+		ihdr.push_back(0);
+		ihdr.push_back(0);
+
+		const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+		std::vector<uint8_t> dst(signature, signature + sizeof(signature));
+		WritePNGChunk(dst, "IHDR", ihdr);
+		WritePNGChunk(dst, "IDAT", idat);
+		WritePNGChunk(dst, "IEND", std::vector<uint8_t>());
+		return dst;
+	}
+
+	static std::vector<uint8_t> EncodePPM(const std::vector<uint8_t>& rgba, const Vec2I& size)
+	{
+		const auto header = "P6\n" + std::to_string(size.X) + " " + std::to_string(size.Y) + "\n255\n";
+
+		std::vector<uint8_t> dst(header.begin(), header.end());
+		dst.reserve(header.size() + static_cast<size_t>(size.X) * size.Y * 3);
+		for (size_t i = 0; i < rgba.size(); i += 4)
+		{
+			dst.push_back(rgba[i + 0]);
+			dst.push_back(rgba[i + 1]);
+			dst.push_back(rgba[i + 2]);
+		}
+		return dst;
+	}
+
+	//! remove padding of rows and convert pixels into RGBA8
+	static bool ConvertToRGBA(
+		const uint8_t* src, const Vec2I& size, int32_t rowPitch, TextureFormatType format, std::vector<uint8_t>& dst)
+	{
+		bool isBGRA = false;
+		if (format == TextureFormatType::B8G8R8A8_UNORM || format == TextureFormatType::B8G8R8A8_UNORM_SRGB)
+		{
+			isBGRA = true;
+		}
+		else if (format != TextureFormatType::R8G8B8A8_UNORM && format != TextureFormatType::R8G8B8A8_UNORM_SRGB)
+		{
+			Log(LogType::Error, "FrameSink : " + to_string(format) + " is not supported.");
+			return false;
+		}
+
+		const auto rowSize = static_cast<size_t>(size.X) * 4;
+		if (rowPitch <= 0)
+		{
+			rowPitch = static_cast<int32_t>(rowSize);
+		}
+
+		dst.resize(rowSize * size.Y);
+
+		for (int32_t y = 0; y < size.Y; y++)
+		{
+			const auto srcRow = src + static_cast<size_t>(y) * rowPitch;
+			const auto dstRow = dst.data() + rowSize * y;
+
+			if (!isBGRA)
+			{
+				memcpy(dstRow, srcRow, rowSize);
+				continue;
+			}
+
+			for (size_t x = 0; x < rowSize; x += 4)
+			{
+				dstRow[x + 0] = srcRow[x + 2];
+				dstRow[x + 1] = srcRow[x + 1];
+				dstRow[x + 2] = srcRow[x + 0];
+				dstRow[x + 3] = srcRow[x + 3];
+			}
+		}
+
+		return true;
+	}
+
+	bool Encode(Job& job, std::vector<uint8_t>& encoded)
+	{
+		const uint8_t* src = nullptr;
+
+		if (job.Ticket != nullptr)
+		{
+			// a timed wait does not flush commands, so it can be called in a worker
+			// it fails soon if a command list was not executed, which would never complete
+			if (!job.Ticket->Wait(parameter_.ReadbackTimeoutMilliseconds))
+			{
+				Log(LogType::Error, "FrameSink : A readback was not executed or finished.");
+				return false;
+			}
+
+			src = static_cast<const uint8_t*>(job.Ticket->GetData());
+		}
+		else
+		{
+			src = job.Data.data();
+		}
+
+		if (src == nullptr)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> rgba;
+		if (!ConvertToRGBA(src, job.Size, job.RowPitch, job.Format, rgba))
+		{
+			return false;
+		}
+
+		// a readback buffer is returned before encoding
+		ReturnTicket(job);
+		job.Data.clear();
+
+		if (parameter_.Format == FrameSinkFormatType::Raw)
+		{
+			encoded = std::move(rgba);
+		}
+		else if (parameter_.Format == FrameSinkFormatType::PPM)
+		{
+			encoded = EncodePPM(rgba, job.Size);
+		}
+		else
+		{
+			encoded = EncodePNG(rgba, job.Size);
+		}
+
+		return true;
+	}
+
+	bool Write(int64_t index, const std::vector<uint8_t>& encoded)
+	{
+		if (parameter_.Output == FrameSinkOutputType::Files)
+		{
+			std::array<char, 512> path;
+			snprintf(path.data(), path.size(), parameter_.PathFormat.c_str(), static_cast<int>(index));
+
+			auto fp = fopen(path.data(), "wb");
+			if (fp == nullptr)
+			{
+				Log(LogType::Error, std::string("FrameSink : Failed to open ") + path.data());
+				return false;
+			}
+
+			const auto result = fwrite(encoded.data(), 1, encoded.size(), fp) == encoded.size();
+			fclose(fp);
+			return result;
+		}
+
+		if (parameter_.Output == FrameSinkOutputType::Stream)
+		{
+			if (parameter_.Stream == nullptr)
+			{
+				return false;
+			}
+
+			const auto result = fwrite(encoded.data(), 1, encoded.size(), parameter_.Stream) == encoded.size();
+			fflush(parameter_.Stream);
+			return result;
+		}
+
+		if (parameter_.Callback)
+		{
+			parameter_.Callback(index, encoded);
+			return true;
+		}
+
+		return false;
+	}
+
+	void Run()
+	{
+		while (true)
+		{
+			Job job;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				jobAdded_.wait(lock, [this]() -> bool { return isExiting_ || !jobs_.empty(); });
+
+				if (jobs_.empty())
+				{
+					break;
+				}
+
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+			}
+
+			jobRemoved_.notify_all();
+
+			std::vector<uint8_t> encoded;
+			auto result = Encode(job, encoded);
+			ReturnTicket(job);
+
+			if (parameter_.Output == FrameSinkOutputType::Files)
+			{
+				result = result && Write(job.Index, encoded);
+			}
+			else
+			{
+				// workers encode in parallel and write in order
+				std::unique_lock<std::mutex> lock(writeMutex_);
+				written_.wait(lock, [this, &job]() -> bool { return nextWriteIndex_ == job.Index; });
+				result = result && Write(job.Index, encoded);
+				nextWriteIndex_++;
+				lock.unlock();
+				written_.notify_all();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				finishedCount_++;
+				if (!result)
+				{
+					failedCount_++;
+				}
+			}
+
+			jobRemoved_.notify_all();
+		}
+	}
+
+	bool Push(Job&& job)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		if (static_cast<int32_t>(jobs_.size()) >= parameter_.MaxQueuedFrameCount)
+		{
+			if (parameter_.DropWhenFull)
+			{
+				droppedCount_++;
+				return false;
+			}
+
+			jobRemoved_.wait(lock, [this]() -> bool { return static_cast<int32_t>(jobs_.size()) < parameter_.MaxQueuedFrameCount; });
+		}
+
+		// indexes are assigned to accepted frames so that dropped frames do not block ordered writes
+		job.Index = submittedCount_;
+		submittedCount_++;
+		jobs_.push_back(std::move(job));
+		lock.unlock();
+
+		jobAdded_.notify_one();
+		return true;
+	}
+
+public:
+	FrameSink(const FrameSinkParameter& parameter) : parameter_(parameter)
+	{
+		parameter_.WorkerCount = std::max(parameter_.WorkerCount, 1);
+		parameter_.MaxQueuedFrameCount = std::max(parameter_.MaxQueuedFrameCount, 1);
+
+		for (int32_t i = 0; i < parameter_.WorkerCount; i++)
+		{
+			workers_.emplace_back([this]() -> void { Run(); });
+		}
+	}
+
+	~FrameSink()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isExiting_ = true;
+		}
+
+		// queued frames are written before workers exit
+		jobAdded_.notify_all();
+
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+
+		ReleaseFinishedTickets();
+	}
+
+	/**
+		@brief	add a frame in cpu memory
+		@param	rowPitch	bytes of a row in data, 0 if rows are not padded
+		@return	false if a frame is dropped
+	*/
+	bool Submit(std::vector<uint8_t>&& data, const Vec2I& size, TextureFormatType format, int32_t rowPitch = 0)
+	{
+		ReleaseFinishedTickets();
+
+		Job job;
+		job.Data = std::move(data);
+		job.Size = size;
+		job.Format = format;
+		job.RowPitch = rowPitch;
+		return Push(std::move(job));
+	}
+
+	/**
+		@brief	add a frame which gpu is copying
+		@note
+		A sink keeps a reference of the ticket until its data is converted.
+		The reference is released in Submit, Flush or the destructor, so that graphics is not disposed in workers.
+		The command list which recorded the ticket must be executed before this call, otherwise the frame fails.
+		@return	false if a frame is dropped
+	*/
+	bool Submit(ReadbackTicket* ticket)
+	{
+		ReleaseFinishedTickets();
+
+		if (ticket == nullptr)
+		{
+			return false;
+		}
+
+		Job job;
+		SafeAssign(job.Ticket, ticket);
+		job.Size = ticket->GetSize();
+		job.Format = ticket->GetFormat();
+		job.RowPitch = ticket->GetRowPitch();
+
+		if (!Push(std::move(job)))
+		{
+			SafeRelease(job.Ticket);
+			return false;
+		}
+
+		return true;
+	}
+
+	//! wait until all submitted frames are written, it must be called in a thread which submits frames
+	void Flush()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobRemoved_.wait(lock, [this]() -> bool { return finishedCount_ == submittedCount_; });
+		}
+
+		ReleaseFinishedTickets();
+	}
+
+	int64_t GetWrittenCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return finishedCount_ - failedCount_;
+	}
+
+	int64_t GetDroppedCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return droppedCount_;
+	}
+
+	int64_t GetFailedCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return failedCount_;
+	}
+};
+
+} // namespace LLGI
@@ -0,0 +1,62 @@
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+
+namespace LLGI
+{
+
+/**
+	@brief	a lock-free ring buffer which one producer thread pushes into and one consumer thread pops from
+	@note
+	N must be a power of two. TryPush fails when the buffer is full.
+*/
+template <typename T, size_t N> class SPSCQueue
+{
+private:
+	static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two.");
+
+	std::array<T, N> items_;
+
+	//! written only by the consumer
+	std::atomic<size_t> head_{0};
+
+	//! written only by the producer
+	std::atomic<size_t> tail_{0};
+
+public:
+	bool TryPush(T&& item)
+	{
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) == N)
+		{
+			return false;
+		}
+
+		items_[tail & (N - 1)] = std::move(item);
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& item)
+	{
+		const auto head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = std::move(items_[head & (N - 1)]);
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+	size_t GetCapacity() const { return N; }
+};
+
+} // namespace LLGI
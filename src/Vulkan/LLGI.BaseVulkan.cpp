@@ -1,4 +1,5 @@
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
 
 namespace LLGI
@@ -132,6 +133,67 @@ void Buffer::Attach(vk::Buffer buffer, vk::DeviceMemory devMem, bool isExternalR
 	isExternalResource_ = isExternalResource;
 }
 
+void Buffer::RemoveRecordedCount(uint64_t queueValue)
+{
+	auto usedValue = usedQueueValue_.load();
+	while (usedValue < queueValue && !usedQueueValue_.compare_exchange_weak(usedValue, queueValue))
+	{
+	}
+
+	recordedCount_--;
+}
+
+bool Buffer::GetIsUsed(GraphicsVulkan* graphics) const
+{
+	if (recordedCount_ > 0)
+	{
+		return true;
+	}
+
+	const auto usedValue = usedQueueValue_.load();
+	auto commandQueue = graphics->GetCommandQueue();
+	return usedValue != 0 && commandQueue != nullptr && !commandQueue->IsCompleted(usedValue);
+}
+
+void DiscardedBuffersVulkan::Push(GraphicsVulkan* graphics, std::unique_ptr<Buffer> buffer, bool isReusable)
+{
+	Entry entry;
+	entry.timeStamp = graphics->GetTimeStamp();
+	entry.buffer = std::move(buffer);
+	entry.isReusable = isReusable;
+	entries_.emplace_back(std::move(entry));
+}
+
+std::unique_ptr<Buffer> DiscardedBuffersVulkan::Pop(GraphicsVulkan* graphics)
+{
+	std::unique_ptr<Buffer> ret;
+
+	for (auto it = entries_.begin(); it != entries_.end();)
+	{
+		if (!graphics->GetIsCompleted(it->timeStamp))
+		{
+			// entries are sorted by time
+			break;
+		}
+
+		// a command list which was recorded before the buffer was replaced may be executed later
+		if (it->buffer->GetIsUsed(graphics))
+		{
+			++it;
+			continue;
+		}
+
+		if (it->isReusable && ret == nullptr)
+		{
+			ret = std::move(it->buffer);
+		}
+
+		it = entries_.erase(it);
+	}
+
+	return ret;
+}
+
 VulkanBuffer::VulkanBuffer() : graphics_(nullptr), nativeBuffer_(VK_NULL_HANDLE), nativeBufferMemory_(VK_NULL_HANDLE), size_(0) {}
 
 bool VulkanBuffer::Initialize(GraphicsVulkan* graphics, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
@@ -203,10 +265,155 @@ static vk::PipelineStageFlags GetStageFlag(vk::ImageLayout layout)
 	{
 		return vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
 	}
+	else if (layout == vk::ImageLayout::eDepthStencilAttachmentOptimal)
+	{
+		return vk::PipelineStageFlagBits::eLateFragmentTests;
+	}
+	else if (layout == vk::ImageLayout::eDepthStencilReadOnlyOptimal)
+	{
+		return vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eFragmentShader;
+	}
 
 	return vk::PipelineStageFlagBits::eTopOfPipe;
 }
 
+/**
+	@brief	get stages and accesses which use an image in a layout
+	@param	isSource	whether it is for commands before a barrier, reading accesses are not required to be available
+*/
+static void GetLayoutStageAndAccess(vk::ImageLayout layout, bool isSource, vk::PipelineStageFlags& stage, vk::AccessFlags& access)
+{
+	switch (layout)
+	{
+	case vk::ImageLayout::eUndefined:
+		stage = vk::PipelineStageFlags();
+		access = vk::AccessFlags();
+		break;
+	case vk::ImageLayout::ePreinitialized:
+		stage = vk::PipelineStageFlagBits::eHost;
+		access = vk::AccessFlagBits::eHostWrite;
+		break;
+	case vk::ImageLayout::eGeneral:
+		// a linear image which cpu writes
+		stage = vk::PipelineStageFlagBits::eHost;
+		access = isSource ? vk::AccessFlags(vk::AccessFlagBits::eHostWrite)
+						  : (vk::AccessFlagBits::eHostRead | vk::AccessFlagBits::eHostWrite);
+		break;
+	case vk::ImageLayout::eTransferSrcOptimal:
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		access = isSource ? vk::AccessFlags() : vk::AccessFlags(vk::AccessFlagBits::eTransferRead);
+		break;
+	case vk::ImageLayout::eTransferDstOptimal:
+		stage = vk::PipelineStageFlagBits::eTransfer;
+		access = vk::AccessFlagBits::eTransferWrite;
+		break;
+	case vk::ImageLayout::eColorAttachmentOptimal:
+		stage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+		access = isSource ? vk::AccessFlags(vk::AccessFlagBits::eColorAttachmentWrite)
+						  : (vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+		break;
+	case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+		stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+		access = isSource ? vk::AccessFlags(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+						  : (vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+
+		// a resolve of depth is written in a stage of color attachments
+		if (isSource)
+		{
+			stage |= vk::PipelineStageFlagBits::eColorAttachmentOutput;
+			access |= vk::AccessFlagBits::eColorAttachmentWrite;
+		}
+		break;
+	case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+		stage = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests |
+				vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		access = isSource ? vk::AccessFlags() : (vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eShaderRead);
+		break;
+	case vk::ImageLayout::eShaderReadOnlyOptimal:
+		stage = vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		access = isSource ? vk::AccessFlags() : vk::AccessFlags(vk::AccessFlagBits::eShaderRead);
+		break;
+	case vk::ImageLayout::ePresentSrcKHR:
+		// a swapchain image is acquired with a semaphore which is waited at this stage
+		stage = isSource ? vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+						 : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eBottomOfPipe);
+		access = vk::AccessFlags();
+		break;
+	default:
+		stage = vk::PipelineStageFlagBits::eAllCommands;
+		access = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+		break;
+	}
+}
+
+void BarrierBatcherVulkan::AddImageBarrier(
+	vk::Image image, const vk::ImageSubresourceRange& range, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, bool isDiscarded)
+{
+	vk::PipelineStageFlags srcStage;
+	vk::PipelineStageFlags dstStage;
+
+	vk::ImageMemoryBarrier barrier;
+	GetLayoutStageAndAccess(oldLayout, true, srcStage, barrier.srcAccessMask);
+	GetLayoutStageAndAccess(newLayout, false, dstStage, barrier.dstAccessMask);
+	barrier.oldLayout = isDiscarded ? vk::ImageLayout::eUndefined : oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = range;
+
+	srcStages_ |= srcStage;
+	dstStages_ |= dstStage;
+	imageBarriers_.push_back(barrier);
+}
+
+void BarrierBatcherVulkan::AddBufferBarrier(vk::Buffer buffer,
+											vk::PipelineStageFlags srcStage,
+											vk::AccessFlags srcAccess,
+											vk::PipelineStageFlags dstStage,
+											vk::AccessFlags dstAccess)
+{
+	vk::BufferMemoryBarrier barrier;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+
+	srcStages_ |= srcStage;
+	dstStages_ |= dstStage;
+	bufferBarriers_.push_back(barrier);
+}
+
+void BarrierBatcherVulkan::Flush(vk::CommandBuffer commandBuffer)
+{
+	if (GetIsEmpty())
+	{
+		return;
+	}
+
+	// stages must not be empty
+	auto srcStages = srcStages_ ? srcStages_ : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eTopOfPipe);
+	auto dstStages = dstStages_ ? dstStages_ : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eBottomOfPipe);
+
+	commandBuffer.pipelineBarrier(srcStages, dstStages, vk::DependencyFlags(), nullptr, bufferBarriers_, imageBarriers_);
+	pipelineBarrierCount_++;
+	imageBarrierCount_ += static_cast<int32_t>(imageBarriers_.size());
+
+	srcStages_ = vk::PipelineStageFlags();
+	dstStages_ = vk::PipelineStageFlags();
+	imageBarriers_.clear();
+	bufferBarriers_.clear();
+}
+
+void BarrierBatcherVulkan::ResetCounts()
+{
+	pipelineBarrierCount_ = 0;
+	imageBarrierCount_ = 0;
+}
+
 void SetImageLayout(vk::CommandBuffer cmdbuffer,
 					vk::Image image,
 					vk::ImageLayout oldImageLayout,
@@ -240,7 +447,7 @@ void SetImageLayout(vk::CommandBuffer cmdbuffer,
 	{
 		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
 	}
-	else if (oldImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
+	else if (oldImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal || oldImageLayout == vk::ImageLayout::eDepthStencilReadOnlyOptimal)
 	{
 		imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
 	}
@@ -267,7 +474,7 @@ void SetImageLayout(vk::CommandBuffer cmdbuffer,
 	{
 		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
 	}
-	else if (newImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
+	else if (newImageLayout == vk::ImageLayout::eShaderReadOnlyOptimal || newImageLayout == vk::ImageLayout::eDepthStencilReadOnlyOptimal)
 	{
 		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
 	}
@@ -326,6 +533,74 @@ uint32_t GetMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits, const v
 	return 0xffffffff;
 }
 
+bool CreateBufferOnUnifiedMemory(GraphicsVulkan* graphics, vk::DeviceSize size, vk::BufferUsageFlags usage, Buffer& buffer)
+{
+	if (!graphics->GetIsUnifiedMemory())
+	{
+		return false;
+	}
+
+	auto device = graphics->GetDevice();
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	vk::Buffer vkBuffer = device.createBuffer(bufferInfo);
+
+	vk::MemoryRequirements memReqs = device.getBufferMemoryRequirements(vkBuffer);
+	uint32_t memoryTypeIndex = 0;
+	if (!graphics->TryGetMemoryTypeIndex(memReqs.memoryTypeBits,
+										 vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible |
+											 vk::MemoryPropertyFlagBits::eHostCoherent,
+										 memoryTypeIndex))
+	{
+		device.destroyBuffer(vkBuffer);
+		return false;
+	}
+
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex = memoryTypeIndex;
+	vk::DeviceMemory devMem = device.allocateMemory(memAlloc);
+	device.bindBufferMemory(vkBuffer, devMem, 0);
+
+	buffer.Attach(vkBuffer, devMem);
+	return true;
+}
+
+bool CreateMappableBuffer(GraphicsVulkan* graphics, vk::DeviceSize size, vk::BufferUsageFlags usage, Buffer& buffer)
+{
+	if (CreateBufferOnUnifiedMemory(graphics, size, usage, buffer))
+	{
+		return true;
+	}
+
+	auto device = graphics->GetDevice();
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	vk::Buffer vkBuffer = device.createBuffer(bufferInfo);
+
+	vk::MemoryRequirements memReqs = device.getBufferMemoryRequirements(vkBuffer);
+	uint32_t memoryTypeIndex = 0;
+	if (!graphics->TryGetMemoryTypeIndex(
+			memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, memoryTypeIndex))
+	{
+		device.destroyBuffer(vkBuffer);
+		return false;
+	}
+
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex = memoryTypeIndex;
+	vk::DeviceMemory devMem = device.allocateMemory(memAlloc);
+	device.bindBufferMemory(vkBuffer, devMem, 0);
+
+	buffer.Attach(vkBuffer, devMem);
+	return true;
+}
+
 bool CreateDepthBuffer(vk::Image& image,
 					   vk::ImageView view,
 					   vk::DeviceMemory devMem,
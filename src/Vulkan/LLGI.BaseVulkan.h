@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../LLGI.Base.h"
+#include <atomic>
 #include <sstream>
 #include <unordered_map>
 
@@ -47,6 +48,9 @@ class PipelineStateVulkan;
 class TextureVulkan;
 class RenderPassVulkan;
 class RenderPassPipelineStateCacheVulkan;
+class ReadbackTicketVulkan;
+class FramebufferCacheVulkan;
+class CommandQueueVulkan;
 
 struct VulkanImageInfo
 {
@@ -70,12 +74,77 @@ class Buffer
 	vk::DeviceMemory devMem_;
 	bool isExternalResource_ = false;
 
+	//! a value of a command queue which is completed when gpu finishes executed commands using this buffer
+	std::atomic<uint64_t> usedQueueValue_{0};
+
+	//! the number of command lists which recorded commands using this buffer and have not executed them
+	std::atomic<int32_t> recordedCount_{0};
+
 public:
 	Buffer(GraphicsVulkan* graphics);
 	virtual ~Buffer();
 	void Attach(vk::Buffer buffer, vk::DeviceMemory devMem, bool isExternalResource = false);
 	vk::Buffer buffer() const { return buffer_; }
 	vk::DeviceMemory devMem() const { return devMem_; }
+
+	//! it is called when a command list records commands using this buffer
+	void AddRecordedCount() { recordedCount_++; }
+
+	/**
+		@brief	it is called when commands which were counted by AddRecordedCount are executed or discarded
+		@param	queueValue	a value of a command queue which the commands are executed with, 0 if they are discarded
+	*/
+	void RemoveRecordedCount(uint64_t queueValue);
+
+	//! it is 0 if commands using this buffer are not executed with a command queue
+	uint64_t GetUsedQueueValue() const { return usedQueueValue_.load(); }
+
+	//! whether gpu may read this buffer, including commands which are recorded and not executed yet
+	bool GetIsUsed(GraphicsVulkan* graphics) const;
+};
+
+/**
+	@brief	a time when commands were executed, which is compared by GraphicsVulkan::GetIsCompleted
+*/
+struct GPUTimeStampVulkan
+{
+	uint64_t PresentedFrameCount = 0;
+	uint64_t WaitFinishCount = 0;
+
+	//! a value of a command queue which is completed when commands executed until the next flush are finished, 0 without a queue
+	uint64_t QueueValue = 0;
+};
+
+/**
+	@brief	buffers which were replaced by Lock(LockMode::Discard) and may be still read by gpu
+	@note
+	A buffer is reused or released after gpu finishes commands which were executed before it was replaced
+	and commands which were recorded with it, even if they are executed after it was replaced.
+*/
+class DiscardedBuffersVulkan
+{
+private:
+	struct Entry
+	{
+		GPUTimeStampVulkan timeStamp;
+		std::unique_ptr<Buffer> buffer;
+		bool isReusable = false;
+	};
+
+	std::vector<Entry> entries_;
+
+public:
+	/**
+		@brief	add a buffer which is not used by cpu anymore
+		@param	isReusable	whether the buffer can be returned by Pop, otherwise it is released when gpu finishes using it
+	*/
+	void Push(GraphicsVulkan* graphics, std::unique_ptr<Buffer> buffer, bool isReusable);
+
+	/**
+		@brief	get a buffer which is not used by gpu
+		@return	nullptr if all buffers are still used
+	*/
+	std::unique_ptr<Buffer> Pop(GraphicsVulkan* graphics);
 };
 
 class VulkanBuffer
@@ -95,6 +164,52 @@ private:
 	VkDeviceSize size_;
 };
 
+/**
+	@brief	barriers which are recorded with one vkCmdPipelineBarrier
+	@note
+	Stages and accesses of image barriers are derived from layouts, so that commands wait only for what they depend on.
+*/
+class BarrierBatcherVulkan
+{
+private:
+	vk::PipelineStageFlags srcStages_;
+	vk::PipelineStageFlags dstStages_;
+	std::vector<vk::ImageMemoryBarrier> imageBarriers_;
+	std::vector<vk::BufferMemoryBarrier> bufferBarriers_;
+	int32_t pipelineBarrierCount_ = 0;
+	int32_t imageBarrierCount_ = 0;
+
+public:
+	/**
+		@brief	add a transition of subresources
+		@param	isDiscarded	whether contents are not preserved, the transition still waits for commands which use oldLayout
+	*/
+	void AddImageBarrier(vk::Image image,
+						 const vk::ImageSubresourceRange& range,
+						 vk::ImageLayout oldLayout,
+						 vk::ImageLayout newLayout,
+						 bool isDiscarded = false);
+
+	void AddBufferBarrier(vk::Buffer buffer,
+						  vk::PipelineStageFlags srcStage,
+						  vk::AccessFlags srcAccess,
+						  vk::PipelineStageFlags dstStage,
+						  vk::AccessFlags dstAccess);
+
+	bool GetIsEmpty() const { return imageBarriers_.empty() && bufferBarriers_.empty(); }
+
+	//! record added barriers, nothing is recorded if it is empty
+	void Flush(vk::CommandBuffer commandBuffer);
+
+	//! the number of vkCmdPipelineBarrier which were recorded since ResetCounts
+	int32_t GetPipelineBarrierCount() const { return pipelineBarrierCount_; }
+
+	//! the number of image barriers which were recorded since ResetCounts
+	int32_t GetImageBarrierCount() const { return imageBarrierCount_; }
+
+	void ResetCounts();
+};
+
 void SetImageLayout(vk::CommandBuffer cmdbuffer,
 					vk::Image image,
 					vk::ImageLayout oldImageLayout,
@@ -103,6 +218,20 @@ void SetImageLayout(vk::CommandBuffer cmdbuffer,
 
 uint32_t GetMemoryTypeIndex(vk::PhysicalDevice& phDevice, uint32_t bits, const vk::MemoryPropertyFlags& properties);
 
+/**
+	@brief	create a buffer on device local memory which is also visible from cpu
+	@note
+	It fails if the device does not have unified memory.
+*/
+bool CreateBufferOnUnifiedMemory(GraphicsVulkan* graphics, vk::DeviceSize size, vk::BufferUsageFlags usage, Buffer& buffer);
+
+/**
+	@brief	create a buffer which can be mapped by cpu and read by gpu without a staging copy
+	@note
+	Unified memory is used if possible, otherwise coherent host memory is used.
+*/
+bool CreateMappableBuffer(GraphicsVulkan* graphics, vk::DeviceSize size, vk::BufferUsageFlags usage, Buffer& buffer);
+
 bool CreateDepthBuffer(vk::Image& image,
 					   vk::ImageView view,
 					   vk::DeviceMemory devMem,
@@ -3,6 +3,7 @@
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
+#include "LLGI.ReadbackVulkan.h"
 #include "LLGI.TextureVulkan.h"
 #include "LLGI.VertexBufferVulkan.h"
 
@@ -60,8 +61,22 @@ CommandListVulkan::CommandListVulkan() {}
 
 CommandListVulkan::~CommandListVulkan()
 {
+	ReleasePendingReadbacks();
+	ReleaseRecordedBuffers(0);
+	layouts_.Reset();
+
 	commandBuffers.clear();
 
+	// command buffers are released with pools
+	chunkCommandBuffers_.clear();
+	fixupCommandBuffers_.clear();
+
+	for (auto& commandPool : commandPools_)
+	{
+		graphics_->GetDevice().destroyCommandPool(commandPool);
+	}
+	commandPools_.clear();
+
 	descriptorPools.clear();
 
 	for (size_t i = 0; i < fences_.size(); i++)
@@ -89,10 +104,24 @@ bool CommandListVulkan::Initialize(GraphicsVulkan* graphics, int32_t drawingCoun
 
 	if (precondition == CommandListPreCondition::Standalone)
 	{
-		vk::CommandBufferAllocateInfo allocInfo;
-		allocInfo.commandPool = graphics->GetCommandPool();
-		allocInfo.commandBufferCount = graphics->GetSwapBufferCount();
-		commandBuffers = graphics->GetDevice().allocateCommandBuffers(allocInfo);
+		vk::CommandPoolCreateInfo poolInfo;
+		poolInfo.queueFamilyIndex = graphics->GetQueueFamilyIndex();
+		poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+
+		commandBuffers.resize(graphics->GetSwapBufferCount());
+		chunkCommandBuffers_.resize(commandBuffers.size());
+		fixupCommandBuffers_.resize(commandBuffers.size());
+
+		for (size_t i = 0; i < commandBuffers.size(); i++)
+		{
+			commandPools_.push_back(graphics->GetDevice().createCommandPool(poolInfo));
+
+			vk::CommandBufferAllocateInfo allocInfo;
+			allocInfo.commandPool = commandPools_[i];
+			allocInfo.commandBufferCount = 1;
+			commandBuffers[i] = graphics->GetDevice().allocateCommandBuffers(allocInfo)[0];
+			chunkCommandBuffers_[i].push_back(commandBuffers[i]);
+		}
 	}
 	else
 	{
@@ -107,6 +136,8 @@ bool CommandListVulkan::Initialize(GraphicsVulkan* graphics, int32_t drawingCoun
 		fences_.emplace_back(graphics->GetDevice().createFence(vk::FenceCreateFlags()));
 	}
 
+	submittedValues_.resize(graphics_->GetSwapBufferCount(), 0);
+
 	// Sampler
 	for (int w = 0; w < 2; w++)
 	{
@@ -151,6 +182,9 @@ void CommandListVulkan::BeginExternal(VkCommandBuffer nativeCommandBuffer)
 	currentSwapBufferIndex_ %= commandBuffers.size();
 
 	commandBuffers[currentSwapBufferIndex_] = vk::CommandBuffer(nativeCommandBuffer);
+	submittedValues_[currentSwapBufferIndex_] = 0;
+	layouts_.Reset();
+	ReleaseRecordedBuffers(0);
 
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
 	dp->Reset();
@@ -158,7 +192,12 @@ void CommandListVulkan::BeginExternal(VkCommandBuffer nativeCommandBuffer)
 	CommandList::Begin();
 }
 
-void CommandListVulkan::EndExternal() { commandBuffers[currentSwapBufferIndex_] = vk::CommandBuffer(); }
+void CommandListVulkan::EndExternal()
+{
+	// an external command buffer is submitted by an application and cannot be preceded by barriers
+	layouts_.Resolve();
+	commandBuffers[currentSwapBufferIndex_] = vk::CommandBuffer();
+}
 
 void CommandListVulkan::Begin()
 {
@@ -166,11 +205,29 @@ void CommandListVulkan::Begin()
 	currentSwapBufferIndex_ %= commandBuffers.size();
 
 	graphics_->GetDevice().resetFences(1, &(fences_[currentSwapBufferIndex_]));
+	submittedValues_[currentSwapBufferIndex_] = 0;
+
+	// readbacks which were recorded but not executed never complete
+	ReleasePendingReadbacks();
+	ReleaseRecordedBuffers(0);
+
+	chunkIndex_ = 0;
+	fixupIndex_ = 0;
+	isChunkExecuted_ = false;
+	layouts_.Reset();
+	barriers_.ResetCounts();
+
+	// all command buffers in this swap index are reset at once and their memory is reused
+	if (!commandPools_.empty())
+	{
+		graphics_->GetDevice().resetCommandPool(commandPools_[currentSwapBufferIndex_], vk::CommandPoolResetFlags());
+		commandBuffers[currentSwapBufferIndex_] = chunkCommandBuffers_[currentSwapBufferIndex_][0];
+	}
 
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-	cmdBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 	cmdBuffer.begin(cmdBufInfo);
 
 	auto& dp = descriptorPools[currentSwapBufferIndex_];
@@ -179,6 +236,47 @@ void CommandListVulkan::Begin()
 	CommandList::Begin();
 }
 
+bool CommandListVulkan::Continue()
+{
+	// commands in a frame are tracked with a command queue instead of a fence
+	if (currentSwapBufferIndex_ < 0 || chunkCommandBuffers_.empty() || graphics_->GetCommandQueue() == nullptr)
+	{
+		return false;
+	}
+
+	// a submitted value is not changed until commands are flushed, so it cannot tell whether current chunk was executed
+	if (!isChunkExecuted_)
+	{
+		Log(LogType::Error, "CommandList : Commands must be executed before Continue.");
+		return false;
+	}
+
+	isChunkExecuted_ = false;
+
+	auto& chunks = chunkCommandBuffers_[currentSwapBufferIndex_];
+	chunkIndex_++;
+
+	if (static_cast<size_t>(chunkIndex_) >= chunks.size())
+	{
+		vk::CommandBufferAllocateInfo allocInfo;
+		allocInfo.commandPool = commandPools_[currentSwapBufferIndex_];
+		allocInfo.commandBufferCount = 1;
+		chunks.push_back(graphics_->GetDevice().allocateCommandBuffers(allocInfo)[0]);
+	}
+
+	// a descriptor pool and references are kept because previous commands in this frame may be running
+	// the command buffer was reset with the pool in Begin
+	commandBuffers[currentSwapBufferIndex_] = chunks[chunkIndex_];
+
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	cmdBuffer.begin(cmdBufInfo);
+
+	CommandList::ContinueInternal();
+	return true;
+}
+
 void CommandListVulkan::End()
 {
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
@@ -217,10 +315,13 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
-	// assign a vertex buffer
+	// assign a vertex buffer, bound buffers are not reused or overwritten in place until gpu finishes them
 	if (isVBDirtied)
 	{
-		vk::DeviceSize vertexOffsets = vb_.offset;
+		vb->GetCurrentBuffer()->AddRecordedCount();
+		recordedBuffers_.push_back(vb->GetCurrentBuffer());
+
+		vk::DeviceSize vertexOffsets = vb->GetOffset() + vb_.offset;
 		vk::Buffer vkBuf = vb->GetBuffer();
 		cmdBuffer.bindVertexBuffers(0, 1, &(vkBuf), &vertexOffsets);
 	}
@@ -228,7 +329,10 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 	// assign an index vuffer
 	if (isIBDirtied)
 	{
-		vk::DeviceSize indexOffset = ib_.offset;
+		ib->GetCurrentBuffer()->AddRecordedCount();
+		recordedBuffers_.push_back(ib->GetCurrentBuffer());
+
+		vk::DeviceSize indexOffset = ib->GetOffset() + ib_.offset;
 		vk::IndexType indexType = vk::IndexType::eUint16;
 
 		if (ib->GetStride() == 2)
@@ -321,6 +425,7 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 			stages[stage_ind] = true;
 
 			auto texture = (TextureVulkan*)currentTextures[stage_ind][unit_ind].texture;
+			layouts_.Use(texture);
 			auto wm = (int32_t)currentTextures[stage_ind][unit_ind].wrapMode;
 			auto mm = (int32_t)currentTextures[stage_ind][unit_ind].minMagFilter;
 
@@ -336,7 +441,7 @@ void CommandListVulkan::Draw(int32_t primitiveCount, int32_t instanceCount)
 				imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 			}
 
-			imageInfo.imageView = texture->GetView();
+			imageInfo.imageView = texture->GetSampledView();
 			imageInfo.sampler = samplers_[wm][mm];
 			descriptorImageInfos[descriptorImageIndex] = imageInfo;
 
@@ -437,11 +542,17 @@ void CommandListVulkan::CopyTexture(Texture* src, Texture* dst)
 	imageCopy[0].dstSubresource.layerCount = 1;
 	imageCopy[0].dstSubresource.baseArrayLayer = 0;
 
-	srcTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eTransferSrcOptimal);
-	dstTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eTransferDstOptimal);
-	cmdBuffer.copyImage(srcTex->GetImage(), srcTex->GetImageLayouts()[0], dstTex->GetImage(), dstTex->GetImageLayouts()[0], imageCopy);
-	dstTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
-	srcTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+	// a destination is overwritten entirely
+	layouts_.Transition(barriers_, srcTex, vk::ImageLayout::eTransferSrcOptimal);
+	layouts_.Transition(barriers_, dstTex, vk::ImageLayout::eTransferDstOptimal, true);
+	barriers_.Flush(cmdBuffer);
+
+	cmdBuffer.copyImage(
+		srcTex->GetImage(), vk::ImageLayout::eTransferSrcOptimal, dstTex->GetImage(), vk::ImageLayout::eTransferDstOptimal, imageCopy);
+
+	layouts_.Transition(barriers_, dstTex, vk::ImageLayout::eShaderReadOnlyOptimal);
+	layouts_.Transition(barriers_, srcTex, vk::ImageLayout::eShaderReadOnlyOptimal);
+	barriers_.Flush(cmdBuffer);
 
 	RegisterReferencedObject(src);
 	RegisterReferencedObject(dst);
@@ -457,8 +568,9 @@ void CommandListVulkan::GenerateMipMap(Texture* src)
 
 	for (int32_t i = 1; i < src->GetMipmapCount(); i++)
 	{
-		srcTex->ResourceBarrior(i - 1, cmdBuffer, vk::ImageLayout::eTransferSrcOptimal);
-		srcTex->ResourceBarrior(i, cmdBuffer, vk::ImageLayout::eTransferDstOptimal);
+		layouts_.Transition(barriers_, srcTex, i - 1, vk::ImageLayout::eTransferSrcOptimal);
+		layouts_.Transition(barriers_, srcTex, i, vk::ImageLayout::eTransferDstOptimal);
+		barriers_.Flush(cmdBuffer);
 
 		vk::ImageBlit blit{};
 		blit.srcOffsets[0] = vk::Offset3D(0, 0, 0);
@@ -486,13 +598,266 @@ void CommandListVulkan::GenerateMipMap(Texture* src)
 		mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
 	}
 
-	srcTex->ResourceBarrior(cmdBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+	// mip levels which have a same layout are transitioned with one range
+	layouts_.Transition(barriers_, srcTex, vk::ImageLayout::eShaderReadOnlyOptimal);
+	barriers_.Flush(cmdBuffer);
+
+	RegisterReferencedObject(src);
+}
+
+CommandListStatistics CommandListVulkan::GetStatistics() const
+{
+	// barriers which are recorded into fixups when commands are executed are not included
+	CommandListStatistics statistics;
+	statistics.PipelineBarrierCount = barriers_.GetPipelineBarrierCount();
+	statistics.ImageBarrierCount = barriers_.GetImageBarrierCount();
+	return statistics;
+}
+
+ReadbackTicket* CommandListVulkan::ReadbackTexture(Texture* texture, const Vec2I& position, const Vec2I& size)
+{
+	if (isInRenderPass_)
+	{
+		Log(LogType::Error, "Please call ReadbackTexture outside of RenderPass");
+		return nullptr;
+	}
+
+	// completion is tracked with values of a command queue
+	if (graphics_->GetCommandQueue() == nullptr || texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto tex = static_cast<TextureVulkan*>(texture);
+
+	if (tex->GetType() == TextureType::Depth)
+	{
+		Log(LogType::Error, "ReadbackTexture : Depth is not supported.");
+		return nullptr;
+	}
+
+	// a multisampled image cannot be copied into a buffer, so it must be resolved before
+	if (tex->GetSamplingCount() > 1)
+	{
+		Log(LogType::Error, "ReadbackTexture : A multisampled texture is not supported.");
+		return nullptr;
+	}
+
+	const auto textureSize = tex->GetSizeAs2D();
+	if (position.X < 0 || position.Y < 0 || size.X <= 0 || size.Y <= 0 || position.X + size.X > textureSize.X ||
+		position.Y + size.Y > textureSize.Y)
+	{
+		Log(LogType::Error, "ReadbackTexture : A region is out of a texture.");
+		return nullptr;
+	}
+
+	const auto rowPitch = GetTextureMemorySize(tex->GetFormat(), Vec2I(size.X, 1));
+	const auto memorySize = GetTextureMemorySize(tex->GetFormat(), size);
+	if (memorySize == 0)
+	{
+		return nullptr;
+	}
+
+	auto pool = graphics_->GetReadbackBufferPool();
+	ReadbackBufferPoolVulkan::Entry entry;
+	if (!pool->Acquire(memorySize, entry))
+	{
+		return nullptr;
+	}
+
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+
+	// a texture is left in a layout in which it is used in this command list or usually is
+	vk::ImageLayout layout;
+	if (!layouts_.TryGetLayout(tex, 0, layout))
+	{
+		layout = tex->GetType() == TextureType::Screen ? vk::ImageLayout::ePresentSrcKHR : vk::ImageLayout::eShaderReadOnlyOptimal;
+	}
+
+	vk::BufferImageCopy region;
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = tex->GetSubresourceRange().aspectMask;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = vk::Offset3D(position.X, position.Y, 0);
+	region.imageExtent = vk::Extent3D(size.X, size.Y, 1);
+
+	layouts_.Transition(barriers_, tex, vk::ImageLayout::eTransferSrcOptimal);
+	barriers_.Flush(cmdBuffer);
+
+	cmdBuffer.copyImageToBuffer(tex->GetImage(), vk::ImageLayout::eTransferSrcOptimal, entry.buffer, region);
+
+	// restore a layout and make written data visible to cpu at once
+	layouts_.Transition(barriers_, tex, layout);
+	barriers_.AddBufferBarrier(entry.buffer,
+							   vk::PipelineStageFlagBits::eTransfer,
+							   vk::AccessFlagBits::eTransferWrite,
+							   vk::PipelineStageFlagBits::eHost,
+							   vk::AccessFlagBits::eHostRead);
+	barriers_.Flush(cmdBuffer);
+
+	RegisterReferencedObject(texture);
+
+	auto ticket = new ReadbackTicketVulkan(graphics_, pool, entry, size, rowPitch, tex->GetFormat());
+
+	// a value is assigned when the command list is executed
+	SafeAddRef(ticket);
+	pendingReadbacks_.push_back(ticket);
+
+	return ticket;
+}
+
+void CommandListVulkan::ReleasePendingReadbacks()
+{
+	for (auto ticket : pendingReadbacks_)
+	{
+		ticket->Release();
+	}
+	pendingReadbacks_.clear();
+}
+
+#if defined(VK_VERSION_1_3)
+void CommandListVulkan::BeginRendering(RenderPassVulkan* renderPass)
+{
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	const auto size = renderPass->GetImageSize();
+	const auto& clearColor = renderPass->GetClearColor();
+
+	std::array<VkRenderingAttachmentInfo, RenderTargetMax> colorAttachments = {};
+	VkRenderingAttachmentInfo depthAttachment = {};
+
+	for (int32_t i = 0; i < renderPass->GetRenderTextureCount(); i++)
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetRenderTexture(i));
+		const auto loadAction = renderPass->GetColorLoadAction(i);
+
+		// contents which are not loaded are discarded
+		layouts_.Transition(barriers_, t, vk::ImageLayout::eColorAttachmentOptimal, loadAction != LoadAction::Load);
+
+		auto& attachment = colorAttachments[i];
+		attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		attachment.imageView = static_cast<VkImageView>(t->GetView());
+		attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachment.loadOp = static_cast<VkAttachmentLoadOp>(RenderPassActionsVulkan::GetLoadOp(loadAction));
+		const auto isResolved = i == 0 && renderPass->GetResolvedRenderTexture() != nullptr;
+		attachment.storeOp =
+			static_cast<VkAttachmentStoreOp>(RenderPassActionsVulkan::GetStoreOp(renderPass->GetColorStoreAction(i), isResolved));
+		attachment.clearValue.color.float32[0] = clearColor.R / 255.0f;
+		attachment.clearValue.color.float32[1] = clearColor.G / 255.0f;
+		attachment.clearValue.color.float32[2] = clearColor.B / 255.0f;
+		attachment.clearValue.color.float32[3] = clearColor.A / 255.0f;
+	}
+
+	if (auto resolved = static_cast<TextureVulkan*>(renderPass->GetResolvedRenderTexture()))
+	{
+		layouts_.Transition(barriers_, resolved, vk::ImageLayout::eColorAttachmentOptimal, true);
+
+		colorAttachments[0].resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+		colorAttachments[0].resolveImageView = static_cast<VkImageView>(resolved->GetView());
+		colorAttachments[0].resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	}
+
+	auto depthTexture = static_cast<TextureVulkan*>(renderPass->GetDepthTexture());
+	if (depthTexture != nullptr)
+	{
+		layouts_.Transition(
+			barriers_, depthTexture, vk::ImageLayout::eDepthStencilAttachmentOptimal, renderPass->GetDepthLoadAction() != LoadAction::Load);
+
+		depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		depthAttachment.imageView = static_cast<VkImageView>(depthTexture->GetView());
+		depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		depthAttachment.loadOp = static_cast<VkAttachmentLoadOp>(RenderPassActionsVulkan::GetLoadOp(renderPass->GetDepthLoadAction()));
+		depthAttachment.storeOp = static_cast<VkAttachmentStoreOp>(
+			RenderPassActionsVulkan::GetStoreOp(renderPass->GetDepthStoreAction(), renderPass->GetResolvedDepthTexture() != nullptr));
+		depthAttachment.clearValue.depthStencil.depth = 1.0f;
+		depthAttachment.clearValue.depthStencil.stencil = 0;
+
+		if (auto resolved = static_cast<TextureVulkan*>(renderPass->GetResolvedDepthTexture()))
+		{
+			layouts_.Transition(barriers_, resolved, vk::ImageLayout::eDepthStencilAttachmentOptimal, true);
+
+			// same as render pass objects, a sample zero is supported with all formats
+			depthAttachment.resolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+			depthAttachment.resolveImageView = static_cast<VkImageView>(resolved->GetView());
+			depthAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		}
+	}
+
+	// all attachments are transitioned with one barrier
+	barriers_.Flush(cmdBuffer);
+
+	VkRenderingInfo renderingInfo = {};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+	renderingInfo.renderArea.extent.width = size.X;
+	renderingInfo.renderArea.extent.height = size.Y;
+	renderingInfo.layerCount = 1;
+	renderingInfo.colorAttachmentCount = static_cast<uint32_t>(renderPass->GetRenderTextureCount());
+	renderingInfo.pColorAttachments = renderingInfo.colorAttachmentCount > 0 ? colorAttachments.data() : nullptr;
+	renderingInfo.pDepthAttachment = depthTexture != nullptr ? &depthAttachment : nullptr;
+	renderingInfo.pStencilAttachment = (depthTexture != nullptr && HasStencil(depthTexture->GetFormat())) ? &depthAttachment : nullptr;
+
+	renderPass->GetRenderPassPipelineStateCache()->BeginRendering(cmdBuffer, renderingInfo);
+
+	vk::Viewport viewport = vk::Viewport(0.0f, 0.0f, static_cast<float>(size.X), static_cast<float>(size.Y), 0.0f, 1.0f);
+	cmdBuffer.setViewport(0, viewport);
+
+	vk::Rect2D scissor = vk::Rect2D(vk::Offset2D(), vk::Extent2D(size.X, size.Y));
+	cmdBuffer.setScissor(0, scissor);
+
+	dynamicRenderPass_ = renderPass;
+}
+
+void CommandListVulkan::EndRendering()
+{
+	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
+	auto renderPass = dynamicRenderPass_;
+	dynamicRenderPass_ = nullptr;
+
+	renderPass->GetRenderPassPipelineStateCache()->EndRendering(cmdBuffer);
+
+	// same final layouts as render pass objects
+	for (int32_t i = 0; i < renderPass->GetRenderTextureCount(); i++)
+	{
+		auto t = static_cast<TextureVulkan*>(renderPass->GetRenderTexture(i));
+		layouts_.Transition(
+			barriers_, t, t->GetType() == TextureType::Screen ? vk::ImageLayout::ePresentSrcKHR : vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+
+	if (auto resolved = static_cast<TextureVulkan*>(renderPass->GetResolvedRenderTexture()))
+	{
+		layouts_.Transition(barriers_, resolved, vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+
+	if (auto depthTexture = static_cast<TextureVulkan*>(renderPass->GetDepthTexture()))
+	{
+		layouts_.Transition(barriers_, depthTexture, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+	}
+
+	if (auto resolved = static_cast<TextureVulkan*>(renderPass->GetResolvedDepthTexture()))
+	{
+		layouts_.Transition(barriers_, resolved, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+	}
+
+	barriers_.Flush(cmdBuffer);
 }
+#endif
 
 void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 {
 	auto renderPass_ = static_cast<RenderPassVulkan*>(renderPass);
 
+#if defined(VK_VERSION_1_3)
+	if (renderPass_->GetIsDynamicRendering())
+	{
+		BeginRendering(renderPass_);
+		CommandList::BeginRenderPass(renderPass);
+		return;
+	}
+#endif
+
 	vk::ClearColorValue clearColor(std::array<float, 4>{renderPass_->GetClearColor().R / 255.0f,
 														renderPass_->GetClearColor().G / 255.0f,
 														renderPass_->GetClearColor().B / 255.0f,
@@ -511,36 +876,46 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
+	// values are indexed by attachments and ignored for attachments which are not cleared
 	vk::ClearValue clear_values[RenderTargetMax + 1];
-	int clearValueCount = 0;
+	int clearValueCount = renderPass_->GetRenderTextureCount();
 
-	if (renderPass->GetIsColorCleared())
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
-		for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
-		{
-			clear_values[i].color = clearColor;
-			clearValueCount++;
-		}
+		clear_values[i].color = clearColor;
 	}
 
-	if (renderPass_->GetHasDepthTexture() && renderPass->GetIsDepthCleared())
+	if (renderPass_->GetHasDepthTexture())
 	{
 		clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
 		clearValueCount++;
 	}
 
-	clear_values[renderPass_->GetRenderTextureCount()].depthStencil = clearDepth;
+	// loaded contents must be in an initial layout of a render pass
+	const auto colorInitialLayout =
+		renderPass_->GetIsSwapchainScreen() ? vk::ImageLayout::ePresentSrcKHR : vk::ImageLayout::eShaderReadOnlyOptimal;
 
-	if (renderPass_->GetHasDepthTexture())
+	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
+	{
+		if (renderPass_->GetColorLoadAction(i) == LoadAction::Load)
+		{
+			auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
+			layouts_.Transition(barriers_, t, colorInitialLayout);
+		}
+	}
+
+	if (renderPass_->GetHasDepthTexture() && renderPass_->GetDepthLoadAction() == LoadAction::Load)
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ResourceBarrior(cmdBuffer, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+		layouts_.Transition(barriers_, t, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
 	}
 
+	barriers_.Flush(cmdBuffer);
+
 	// begin renderpass
 	vk::RenderPassBeginInfo renderPassBeginInfo;
 	renderPassBeginInfo.framebuffer = renderPass_->frameBuffer_;
-	renderPassBeginInfo.renderPass = renderPass_->renderPassPipelineState->GetRenderPass();
+	renderPassBeginInfo.renderPass = renderPass_->GetRenderPassToBegin();
 	renderPassBeginInfo.renderArea.extent = vk::Extent2D(renderPass_->GetImageSize().X, renderPass_->GetImageSize().Y);
 	renderPassBeginInfo.clearValueCount = clearValueCount;
 	renderPassBeginInfo.pClearValues = clear_values;
@@ -557,7 +932,7 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 	for (int32_t i = 0; i < renderPass_->GetRenderTextureCount(); i++)
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetRenderTexture(i));
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(i));
+		layouts_.SetLayout(t, renderPass_->renderPassPipelineState->finalLayouts_.at(i));
 	}
 
 	layoutOffset += renderPass_->GetRenderTextureCount();
@@ -565,7 +940,7 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 	if (renderPass_->GetHasDepthTexture())
 	{
 		auto t = static_cast<TextureVulkan*>(renderPass_->GetDepthTexture());
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
+		layouts_.SetLayout(t, renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
 	}
 
 	if (renderPass_->GetHasDepthTexture())
@@ -575,7 +950,13 @@ void CommandListVulkan::BeginRenderPass(RenderPass* renderPass)
 
 	if (auto t = static_cast<TextureVulkan*>(renderPass_->GetResolvedRenderTexture()))
 	{
-		t->ChangeImageLayout(renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
+		layouts_.SetLayout(t, renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
+		layoutOffset += 1;
+	}
+
+	if (auto t = static_cast<TextureVulkan*>(renderPass_->GetResolvedDepthTexture()))
+	{
+		layouts_.SetLayout(t, renderPass_->renderPassPipelineState->finalLayouts_.at(layoutOffset));
 	}
 
 	CommandList::BeginRenderPass(renderPass);
@@ -585,6 +966,15 @@ void CommandListVulkan::EndRenderPass()
 {
 	auto& cmdBuffer = commandBuffers[currentSwapBufferIndex_];
 
+#if defined(VK_VERSION_1_3)
+	if (dynamicRenderPass_ != nullptr)
+	{
+		EndRendering();
+		CommandList::EndRenderPass();
+		return;
+	}
+#endif
+
 	// end renderpass
 	cmdBuffer.endRenderPass();
 
@@ -597,10 +987,85 @@ vk::CommandBuffer CommandListVulkan::GetCommandBuffer() const
 	return cmdBuffer;
 }
 
+vk::CommandBuffer CommandListVulkan::ResolveImageLayouts(uint64_t queueValue)
+{
+	BarrierBatcherVulkan batcher;
+	layouts_.Resolve(batcher, queueValue);
+
+	if (batcher.GetIsEmpty() || commandPools_.empty())
+	{
+		return vk::CommandBuffer();
+	}
+
+	// a fix-up command buffer is reset with the pool in Begin
+	auto& fixups = fixupCommandBuffers_[currentSwapBufferIndex_];
+	if (static_cast<size_t>(fixupIndex_) >= fixups.size())
+	{
+		vk::CommandBufferAllocateInfo allocInfo;
+		allocInfo.commandPool = commandPools_[currentSwapBufferIndex_];
+		allocInfo.commandBufferCount = 1;
+		fixups.push_back(graphics_->GetDevice().allocateCommandBuffers(allocInfo)[0]);
+	}
+
+	auto fixup = fixups[fixupIndex_];
+	fixupIndex_++;
+
+	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	fixup.begin(cmdBufInfo);
+	batcher.Flush(fixup);
+	fixup.end();
+
+	return fixup;
+}
+
 vk::Fence CommandListVulkan::GetFence() const { return fences_[currentSwapBufferIndex_]; }
 
+void CommandListVulkan::SetSubmittedValue(uint64_t value)
+{
+	submittedValues_[currentSwapBufferIndex_] = value;
+	isChunkExecuted_ = true;
+
+	for (auto ticket : pendingReadbacks_)
+	{
+		ticket->SetSubmittedValue(value);
+	}
+	ReleasePendingReadbacks();
+	ReleaseRecordedBuffers(value);
+}
+
+void CommandListVulkan::ReleaseRecordedBuffers(uint64_t queueValue)
+{
+	for (auto buffer : recordedBuffers_)
+	{
+		buffer->RemoveRecordedCount(queueValue);
+	}
+	recordedBuffers_.clear();
+}
+
+uint64_t CommandListVulkan::GetSubmittedValue() const
+{
+	if (currentSwapBufferIndex_ < 0)
+	{
+		return 0;
+	}
+
+	return submittedValues_[currentSwapBufferIndex_];
+}
+
 void CommandListVulkan::WaitUntilCompleted()
 {
+	auto commandQueue = graphics_->GetCommandQueue();
+	if (commandQueue != nullptr)
+	{
+		auto value = GetSubmittedValue();
+		if (value > 0)
+		{
+			commandQueue->Wait(value);
+		}
+		return;
+	}
+
 	if (currentSwapBufferIndex_ >= 0)
 	{
 		vk::Result fenceRes =
@@ -612,4 +1077,21 @@ void CommandListVulkan::WaitUntilCompleted()
 	}
 }
 
+bool CommandListVulkan::IsCompleted()
+{
+	auto commandQueue = graphics_->GetCommandQueue();
+	if (commandQueue != nullptr)
+	{
+		auto value = GetSubmittedValue();
+		return value == 0 || commandQueue->IsCompleted(value);
+	}
+
+	if (currentSwapBufferIndex_ < 0)
+	{
+		return true;
+	}
+
+	return graphics_->GetDevice().getFenceStatus(fences_[currentSwapBufferIndex_]) == vk::Result::eSuccess;
+}
+
 } // namespace LLGI
@@ -2,6 +2,7 @@
 
 #include "../LLGI.CommandList.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.ImageLayoutTrackerVulkan.h"
 
 namespace LLGI
 {
@@ -31,11 +32,63 @@ class CommandListVulkan : public CommandList
 private:
 	std::shared_ptr<GraphicsVulkan> graphics_;
 	std::vector<vk::CommandBuffer> commandBuffers;
+
+	/**
+		@brief	transient command pools for each swap index
+		@note
+		A pool is reset at once in Begin instead of resetting each command buffer.
+		Command lists can be recorded in different threads because each command list has its own pools.
+	*/
+	std::vector<vk::CommandPool> commandPools_;
+
+	//! command buffers for each swap index, which are used in order by Continue in a frame
+	std::vector<std::vector<vk::CommandBuffer>> chunkCommandBuffers_;
+	int32_t chunkIndex_ = 0;
+
+	//! command buffers for each swap index, which transition textures into layouts which chunks expect
+	std::vector<std::vector<vk::CommandBuffer>> fixupCommandBuffers_;
+	int32_t fixupIndex_ = 0;
+
+	//! whether current chunk was executed after Begin or Continue was called last time
+	bool isChunkExecuted_ = false;
 	std::vector<std::shared_ptr<DescriptorPoolVulkan>> descriptorPools;
 	int32_t currentSwapBufferIndex_;
 	std::vector<vk::Fence> fences_;
+
+	//! values of a command queue which were assigned when commands were executed
+	std::vector<uint64_t> submittedValues_;
 	vk::Sampler samplers_[2][2];
 
+	//! tickets which are recorded but not executed
+	std::vector<ReadbackTicketVulkan*> pendingReadbacks_;
+
+	//! buffers which are bound since commands were executed last time, they are counted until commands are executed or discarded
+	std::vector<Buffer*> recordedBuffers_;
+
+	void ReleaseRecordedBuffers(uint64_t queueValue);
+
+	void ReleasePendingReadbacks();
+
+	//! transitions which are recorded together before a command
+	BarrierBatcherVulkan barriers_;
+
+	//! layouts of textures which are expected and changed by recorded commands
+	ImageLayoutTrackerVulkan layouts_;
+
+	//! a render pass which is begun with vkCmdBeginRendering and not ended
+	RenderPassVulkan* dynamicRenderPass_ = nullptr;
+
+#if defined(VK_VERSION_1_3)
+	/**
+		@brief	begin a render pass without render pass objects
+		@note
+		Attachments are transitioned explicitly into layouts which render pass objects use.
+	*/
+	void BeginRendering(RenderPassVulkan* renderPass);
+
+	void EndRendering();
+#endif
+
 public:
 	CommandListVulkan();
 	~CommandListVulkan() override;
@@ -44,6 +97,7 @@ public:
 	Initialize(GraphicsVulkan* graphics, int32_t drawingCount, CommandListPreCondition precondition = CommandListPreCondition::Standalone);
 
 	void Begin() override;
+	bool Continue() override;
 	void End() override;
 
 	void BeginExternal(VkCommandBuffer nativeCommandBuffer);
@@ -55,12 +109,32 @@ public:
 
 	void GenerateMipMap(Texture* src) override;
 
+	using CommandList::ReadbackTexture;
+	ReadbackTicket* ReadbackTexture(Texture* texture, const Vec2I& position, const Vec2I& size) override;
+
+	CommandListStatistics GetStatistics() const override;
+
 	void BeginRenderPass(RenderPass* renderPass) override;
 	void EndRenderPass() override;
 	vk::CommandBuffer GetCommandBuffer() const;
+
+	/**
+		@brief	change layouts of textures with recorded commands and get commands which must be submitted before them
+		@note
+		It must be called when commands are executed, and returns null if textures are already in expected layouts.
+		@param	queueValue	a value of a command queue with which commands are executed, 0 without a queue
+	*/
+	vk::CommandBuffer ResolveImageLayouts(uint64_t queueValue);
 	vk::Fence GetFence() const;
 
+	void SetSubmittedValue(uint64_t value);
+
+	//! a value of a command queue which is completed when current commands are finished, 0 if they are not executed
+	uint64_t GetSubmittedValue() const;
+
 	void WaitUntilCompleted() override;
+
+	bool IsCompleted() override;
 };
 
 } // namespace LLGI
@@ -0,0 +1,550 @@
+#include "LLGI.CommandQueueVulkan.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace LLGI
+{
+
+CommandQueueVulkan::CommandQueueVulkan(vk::Device device, vk::Queue queue, bool isTimelineSemaphoreEnabled, bool isSubmissionThreadEnabled)
+	: device_(device), queue_(queue)
+{
+#if defined(VK_KHR_timeline_semaphore)
+	if (isTimelineSemaphoreEnabled)
+	{
+		waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(device_.getProcAddr("vkWaitSemaphoresKHR"));
+		getSemaphoreCounterValue =
+			reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(device_.getProcAddr("vkGetSemaphoreCounterValueKHR"));
+
+		if (waitSemaphores != nullptr && getSemaphoreCounterValue != nullptr)
+		{
+			VkSemaphoreTypeCreateInfoKHR typeCreateInfo = {};
+			typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+			typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+			typeCreateInfo.initialValue = 0;
+
+			VkSemaphoreCreateInfo createInfo = {};
+			createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			createInfo.pNext = &typeCreateInfo;
+
+			VkSemaphore semaphore = VK_NULL_HANDLE;
+			if (vkCreateSemaphore(static_cast<VkDevice>(device_), &createInfo, nullptr, &semaphore) == VK_SUCCESS)
+			{
+				timelineSemaphore_ = vk::Semaphore(semaphore);
+			}
+		}
+	}
+#endif
+
+	if (isSubmissionThreadEnabled)
+	{
+		submissionThread_ = std::thread([this]() -> void { RunSubmissionThread(); });
+	}
+}
+
+CommandQueueVulkan::~CommandQueueVulkan()
+{
+	WaitIdle();
+
+	if (submissionThread_.joinable())
+	{
+		Task task;
+		task.type = TaskType::Exit;
+		PushTask(std::move(task));
+		submissionThread_.join();
+	}
+
+	for (auto& fence : freeFences_)
+	{
+		device_.destroyFence(fence);
+	}
+	freeFences_.clear();
+
+	if (timelineSemaphore_)
+	{
+		device_.destroySemaphore(timelineSemaphore_);
+	}
+}
+
+vk::Fence CommandQueueVulkan::GetFence()
+{
+	// a fence which is waited in other threads may be retired but must not be reset
+	if (freeFences_.empty() || fenceWaiterCount_ > 0)
+	{
+		return device_.createFence(vk::FenceCreateInfo());
+	}
+
+	auto fence = freeFences_.back();
+	freeFences_.pop_back();
+	device_.resetFences(1, &fence);
+	return fence;
+}
+
+vk::Result CommandQueueVulkan::WaitForFence(std::unique_lock<std::mutex>& lock, vk::Fence fence, uint64_t timeout)
+{
+	fenceWaiterCount_++;
+	lock.unlock();
+	// it is called in other threads, so an error is returned instead of an exception
+	auto vkFence = static_cast<VkFence>(fence);
+	auto result = vkWaitForFences(static_cast<VkDevice>(device_), 1, &vkFence, VK_TRUE, timeout);
+	lock.lock();
+	fenceWaiterCount_--;
+	return static_cast<vk::Result>(result);
+}
+
+void CommandQueueVulkan::PushTask(Task&& task)
+{
+	// the thread consumes tasks soon if a ring buffer is full
+	while (!tasks_.TryPush(std::move(task)))
+	{
+		std::this_thread::yield();
+	}
+
+	pushedTaskCount_++;
+
+	// the lock prevents the thread from missing a notification before sleeping
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex_);
+	}
+	wakeCondition_.notify_one();
+}
+
+vk::Result CommandQueueVulkan::ProcessTask(Task& task)
+{
+	if (task.type == TaskType::Present)
+	{
+		vk::PresentInfoKHR presentInfo;
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = &task.swapchain;
+		presentInfo.pImageIndices = &task.imageIndex;
+		presentInfo.waitSemaphoreCount = task.presentWaitSemaphore ? 1 : 0;
+		presentInfo.pWaitSemaphores = &task.presentWaitSemaphore;
+
+		// an exception must not be thrown in the submission thread, so any error is returned to the owner thread
+		auto result = vkQueuePresentKHR(static_cast<VkQueue>(queue_), reinterpret_cast<const VkPresentInfoKHR*>(&presentInfo));
+		return static_cast<vk::Result>(result);
+	}
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(task.waitSemaphores.size());
+	submitInfo.pWaitSemaphores = task.waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = task.waitStages.data();
+	submitInfo.commandBufferCount = static_cast<uint32_t>(task.commandBuffers.size());
+	submitInfo.pCommandBuffers = task.commandBuffers.data();
+
+#if defined(VK_KHR_timeline_semaphore)
+	// values for binary semaphores are ignored
+	std::vector<uint64_t> signalValues(task.signalSemaphores.size(), 0);
+	VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+
+	if (timelineSemaphore_)
+	{
+		task.signalSemaphores.push_back(timelineSemaphore_);
+		signalValues.push_back(task.value);
+
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+		timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(task.waitValues.size());
+		timelineInfo.pWaitSemaphoreValues = task.waitValues.data();
+		timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+		timelineInfo.pSignalSemaphoreValues = signalValues.data();
+		submitInfo.pNext = &timelineInfo;
+	}
+#endif
+
+	submitInfo.signalSemaphoreCount = static_cast<uint32_t>(task.signalSemaphores.size());
+	submitInfo.pSignalSemaphores = task.signalSemaphores.data();
+
+	// an exception must not be thrown in the submission thread
+	auto result = vkQueueSubmit(static_cast<VkQueue>(queue_),
+								1,
+								reinterpret_cast<const VkSubmitInfo*>(&submitInfo),
+								static_cast<VkFence>(task.fence));
+
+	if (result != VK_SUCCESS)
+	{
+		Log(LogType::Error, "CommandQueue : Failed to submit commands.");
+		lastSubmitResult_.store(static_cast<int32_t>(result));
+
+		// the value is completed without commands after previous submissions, otherwise waits for it never end
+		// semaphores are also waited and signaled so that an acquired image and a present are not left
+		submitInfo.commandBufferCount = 0;
+		submitInfo.pCommandBuffers = nullptr;
+		if (vkQueueSubmit(static_cast<VkQueue>(queue_),
+						  1,
+						  reinterpret_cast<const VkSubmitInfo*>(&submitInfo),
+						  static_cast<VkFence>(task.fence)) != VK_SUCCESS)
+		{
+			Log(LogType::Error, "CommandQueue : Failed to complete a value of failed commands.");
+			isLost_.store(true);
+		}
+	}
+
+	return static_cast<vk::Result>(result);
+}
+
+void CommandQueueVulkan::RunSubmissionThread()
+{
+	while (true)
+	{
+		Task task;
+		if (!tasks_.TryPop(task))
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex_);
+			wakeCondition_.wait(lock, [this]() -> bool { return !tasks_.IsEmpty(); });
+			continue;
+		}
+
+		if (task.type == TaskType::Exit)
+		{
+			return;
+		}
+
+		auto result = ProcessTask(task);
+
+		if (task.type == TaskType::Present && result != vk::Result::eSuccess)
+		{
+			lastPresentResult_.store(static_cast<int32_t>(result));
+		}
+
+		processedTaskCount_.fetch_add(1, std::memory_order_release);
+	}
+}
+
+void CommandQueueVulkan::UpdateCompletedValue()
+{
+#if defined(VK_KHR_timeline_semaphore)
+	if (timelineSemaphore_)
+	{
+		auto semaphore = static_cast<VkSemaphore>(timelineSemaphore_);
+
+		uint64_t value = 0;
+		if (getSemaphoreCounterValue(static_cast<VkDevice>(device_), semaphore, &value) == VK_SUCCESS)
+		{
+			completedValue_.store(std::max(completedValue_.load(), value));
+		}
+		return;
+	}
+#endif
+
+	while (!submittedFences_.empty())
+	{
+		auto& front = submittedFences_.front();
+
+		if (device_.getFenceStatus(front.fence) != vk::Result::eSuccess)
+		{
+			return;
+		}
+
+		completedValue_ = front.value;
+		freeFences_.push_back(front.fence);
+		submittedFences_.pop_front();
+	}
+}
+
+uint64_t CommandQueueVulkan::Enqueue(vk::CommandBuffer commandBuffer)
+{
+	commandBuffers_.push_back(commandBuffer);
+	enqueuedCount_++;
+	return submittedValue_ + 1;
+}
+
+void CommandQueueVulkan::AddWaitSemaphore(vk::Semaphore semaphore, vk::PipelineStageFlags stage)
+{
+	waitSemaphores_.push_back(semaphore);
+	waitStages_.push_back(stage);
+	waitValues_.push_back(0);
+}
+
+void CommandQueueVulkan::AddSignalSemaphore(vk::Semaphore semaphore) { signalSemaphores_.push_back(semaphore); }
+
+void CommandQueueVulkan::AddWaitValue(uint64_t value)
+{
+	// commands in the same submission are not ordered, so a dependency is made between submissions
+	if (value > submittedValue_)
+	{
+		Flush();
+	}
+
+	if (value > submittedValue_ || IsCompleted(value))
+	{
+		return;
+	}
+
+	if (!timelineSemaphore_)
+	{
+		Wait(value);
+		return;
+	}
+
+	waitSemaphores_.push_back(timelineSemaphore_);
+	waitStages_.push_back(vk::PipelineStageFlagBits::eAllCommands);
+	waitValues_.push_back(value);
+}
+
+vk::Result CommandQueueVulkan::PopSubmitResult()
+{
+	return static_cast<vk::Result>(lastSubmitResult_.exchange(static_cast<int32_t>(VK_SUCCESS)));
+}
+
+uint64_t CommandQueueVulkan::Flush()
+{
+	// semaphores are kept for a submission with commands, which waits or signals them
+	if (commandBuffers_.empty())
+	{
+		return submittedValue_;
+	}
+
+	const auto value = submittedValue_ + 1;
+
+	Task task;
+	task.type = TaskType::Submit;
+	task.commandBuffers.swap(commandBuffers_);
+	task.waitSemaphores.swap(waitSemaphores_);
+	task.waitStages.swap(waitStages_);
+	task.waitValues.swap(waitValues_);
+	task.signalSemaphores.swap(signalSemaphores_);
+	task.value = value;
+
+	// a fence can be waited before the submission thread submits it
+	if (!timelineSemaphore_)
+	{
+		std::lock_guard<std::mutex> lock(completionMutex_);
+		task.fence = GetFence();
+
+		SubmittedFence submitted;
+		submitted.value = value;
+		submitted.fence = task.fence;
+		submittedFences_.push_back(submitted);
+		fenceAdded_.notify_all();
+	}
+
+	if (GetIsSubmissionThreadEnabled())
+	{
+		PushTask(std::move(task));
+	}
+	else
+	{
+		ProcessTask(task);
+	}
+
+	submittedValue_ = value;
+
+	return submittedValue_;
+}
+
+vk::Result CommandQueueVulkan::Present(vk::SwapchainKHR swapchain, uint32_t imageIndex, vk::Semaphore waitSemaphore)
+{
+	Task task;
+	task.type = TaskType::Present;
+	task.swapchain = swapchain;
+	task.imageIndex = imageIndex;
+	task.presentWaitSemaphore = waitSemaphore;
+
+	if (!GetIsSubmissionThreadEnabled())
+	{
+		return ProcessTask(task);
+	}
+
+	PushTask(std::move(task));
+	presentedTaskCount_ = pushedTaskCount_;
+	return static_cast<vk::Result>(lastPresentResult_.exchange(static_cast<int32_t>(VK_SUCCESS)));
+}
+
+void CommandQueueVulkan::WaitPresents()
+{
+	while (processedTaskCount_.load(std::memory_order_acquire) < presentedTaskCount_)
+	{
+		std::this_thread::yield();
+	}
+}
+
+bool CommandQueueVulkan::IsCompleted(uint64_t value)
+{
+	if (completedValue_ >= value)
+	{
+		return true;
+	}
+
+	// other thread is retiring fences
+	std::unique_lock<std::mutex> lock(completionMutex_, std::try_to_lock);
+	if (lock.owns_lock())
+	{
+		UpdateCompletedValue();
+	}
+
+	return completedValue_ >= value;
+}
+
+bool CommandQueueVulkan::Wait(uint64_t value)
+{
+	if (value > submittedValue_)
+	{
+		Flush();
+	}
+
+	// nothing is submitted with the value, or it is never completed
+	if (value > submittedValue_ || isLost_)
+	{
+		return false;
+	}
+
+	if (IsCompleted(value))
+	{
+		return true;
+	}
+
+	// the mutex is not locked while waiting on gpu, so other threads can check and retire completed values
+
+#if defined(VK_KHR_timeline_semaphore)
+	if (timelineSemaphore_)
+	{
+		auto semaphore = static_cast<VkSemaphore>(timelineSemaphore_);
+
+		VkSemaphoreWaitInfoKHR waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &semaphore;
+		waitInfo.pValues = &value;
+
+		if (waitSemaphores(static_cast<VkDevice>(device_), &waitInfo, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS)
+		{
+			Log(LogType::Error, "CommandQueue : Failed to wait a semaphore.");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(completionMutex_);
+		completedValue_.store(std::max(completedValue_.load(), value));
+		return true;
+	}
+#endif
+
+	std::unique_lock<std::mutex> lock(completionMutex_);
+
+	while (!isLost_)
+	{
+		UpdateCompletedValue();
+
+		if (completedValue_ >= value || submittedFences_.empty())
+		{
+			break;
+		}
+
+		// the fence is not reset by Flush in other threads while it is waited
+		if (WaitForFence(lock, submittedFences_.front().fence, std::numeric_limits<uint64_t>::max()) != vk::Result::eSuccess)
+		{
+			Log(LogType::Error, "CommandQueue : Failed to wait a fence.");
+			return false;
+		}
+	}
+
+	return completedValue_ >= value;
+}
+
+bool CommandQueueVulkan::WaitFor(uint64_t value, uint64_t timeout)
+{
+	if (IsCompleted(value))
+	{
+		return true;
+	}
+
+	if (isLost_)
+	{
+		return false;
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout);
+
+	auto getRemainingTime = [&deadline]() -> uint64_t {
+		auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+		return remaining > 0 ? static_cast<uint64_t>(remaining) : 0;
+	};
+
+#if defined(VK_KHR_timeline_semaphore)
+	if (timelineSemaphore_)
+	{
+		// a value can be waited before it is signaled
+		auto semaphore = static_cast<VkSemaphore>(timelineSemaphore_);
+
+		VkSemaphoreWaitInfoKHR waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &semaphore;
+		waitInfo.pValues = &value;
+
+		auto result = waitSemaphores(static_cast<VkDevice>(device_), &waitInfo, timeout);
+		if (result == VK_TIMEOUT)
+		{
+			return false;
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			Log(LogType::Error, "CommandQueue : Failed to wait a semaphore.");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(completionMutex_);
+		completedValue_.store(std::max(completedValue_.load(), value));
+		return true;
+	}
+#endif
+
+	std::unique_lock<std::mutex> lock(completionMutex_);
+
+	while (true)
+	{
+		UpdateCompletedValue();
+
+		if (completedValue_ >= value)
+		{
+			return true;
+		}
+
+		auto it = std::find_if(submittedFences_.begin(), submittedFences_.end(), [value](const SubmittedFence& submitted) -> bool {
+			return submitted.value >= value;
+		});
+
+		// the value is not flushed yet
+		if (it == submittedFences_.end())
+		{
+			if (fenceAdded_.wait_until(lock, deadline) == std::cv_status::timeout)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		// the mutex is not locked while waiting on gpu, and the fence is not reset by Flush in other threads meanwhile
+		auto result = WaitForFence(lock, it->fence, getRemainingTime());
+
+		if (result == vk::Result::eTimeout)
+		{
+			return false;
+		}
+
+		if (result != vk::Result::eSuccess)
+		{
+			Log(LogType::Error, "CommandQueue : Failed to wait a fence.");
+			return false;
+		}
+	}
+}
+
+void CommandQueueVulkan::WaitIdle()
+{
+	Flush();
+
+	// fences and semaphores must be submitted before other threads use the queue
+	while (processedTaskCount_.load(std::memory_order_acquire) != pushedTaskCount_)
+	{
+		std::this_thread::yield();
+	}
+
+	// the mutex is locked only to retire fences, so that bounded waits in other threads are not blocked during gpu work
+	Wait(submittedValue_);
+
+	std::lock_guard<std::mutex> lock(completionMutex_);
+	UpdateCompletedValue();
+}
+
+} // namespace LLGI
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "../Utils/LLGI.SPSCQueue.h"
+#include "LLGI.BaseVulkan.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace LLGI
+{
+
+/**
+	@brief	a queue which collects command buffers and submits them together
+	@note
+	A value is assigned to each submission in increasing order.
+	Commands which were enqueued with a value are finished when the value is completed.
+	Values are tracked with a timeline semaphore if it is supported, otherwise with fences.
+	If a submission thread is enabled, vkQueueSubmit and vkQueuePresentKHR are called only in the thread
+	and Flush and Present return without waiting for a driver.
+*/
+class CommandQueueVulkan : public ReferenceObject
+{
+private:
+	struct SubmittedFence
+	{
+		uint64_t value = 0;
+		vk::Fence fence;
+	};
+
+	enum class TaskType
+	{
+		Submit,
+		Present,
+		Exit,
+	};
+
+	//! a work which is passed to the queue directly or through the submission thread
+	struct Task
+	{
+		TaskType type = TaskType::Submit;
+
+		std::vector<vk::CommandBuffer> commandBuffers;
+		std::vector<vk::Semaphore> waitSemaphores;
+		std::vector<vk::PipelineStageFlags> waitStages;
+		std::vector<uint64_t> waitValues;
+		std::vector<vk::Semaphore> signalSemaphores;
+		uint64_t value = 0;
+		vk::Fence fence;
+
+		vk::SwapchainKHR swapchain;
+		uint32_t imageIndex = 0;
+		vk::Semaphore presentWaitSemaphore;
+	};
+
+	vk::Device device_;
+	vk::Queue queue_;
+
+	std::vector<vk::CommandBuffer> commandBuffers_;
+	std::vector<vk::Semaphore> waitSemaphores_;
+	std::vector<vk::PipelineStageFlags> waitStages_;
+	std::vector<uint64_t> waitValues_;
+	std::vector<vk::Semaphore> signalSemaphores_;
+
+	std::deque<SubmittedFence> submittedFences_;
+	std::vector<vk::Fence> freeFences_;
+
+	//! threads which wait on fences without completionMutex_, retired fences are not reset while they wait
+	int32_t fenceWaiterCount_ = 0;
+
+	vk::Semaphore timelineSemaphore_;
+
+#if defined(VK_KHR_timeline_semaphore)
+	PFN_vkWaitSemaphoresKHR waitSemaphores = nullptr;
+	PFN_vkGetSemaphoreCounterValueKHR getSemaphoreCounterValue = nullptr;
+#endif
+
+	//! it is changed only in a thread which flushes, and read in any thread
+	std::atomic<uint64_t> submittedValue_{0};
+	std::atomic<uint64_t> completedValue_{0};
+
+	//! IsCompleted may be called in other threads while fences are retired
+	std::mutex completionMutex_;
+
+	//! notified when a fence is added in Flush, for WaitFor in other threads
+	std::condition_variable fenceAdded_;
+	uint64_t enqueuedCount_ = 0;
+
+	SPSCQueue<Task, 64> tasks_;
+	std::thread submissionThread_;
+	std::mutex wakeMutex_;
+	std::condition_variable wakeCondition_;
+	uint64_t pushedTaskCount_ = 0;
+	std::atomic<uint64_t> processedTaskCount_{0};
+	std::atomic<int32_t> lastPresentResult_{static_cast<int32_t>(VK_SUCCESS)};
+	std::atomic<int32_t> lastSubmitResult_{static_cast<int32_t>(VK_SUCCESS)};
+
+	//! whether a value of failed commands could not be completed, waits fail instead of blocking forever
+	std::atomic<bool> isLost_{false};
+
+	//! the number of tasks which had been pushed when an image was presented last
+	uint64_t presentedTaskCount_ = 0;
+
+	//! get a fence which is not signaled, completionMutex_ must be locked
+	vk::Fence GetFence();
+
+	//! wait on a fence without completionMutex_ which is locked by lock
+	vk::Result WaitForFence(std::unique_lock<std::mutex>& lock, vk::Fence fence, uint64_t timeout);
+
+	void PushTask(Task&& task);
+
+	vk::Result ProcessTask(Task& task);
+
+	void RunSubmissionThread();
+
+	//! update a completed value with signaled fences or a timeline semaphore without waiting, completionMutex_ must be locked
+	void UpdateCompletedValue();
+
+public:
+	CommandQueueVulkan(vk::Device device,
+					   vk::Queue queue,
+					   bool isTimelineSemaphoreEnabled = false,
+					   bool isSubmissionThreadEnabled = false);
+	~CommandQueueVulkan() override;
+
+	/**
+		@brief	add a command buffer which is submitted in next Flush
+		@return	a value which is completed when the command buffer is finished
+	*/
+	uint64_t Enqueue(vk::CommandBuffer commandBuffer);
+
+	//! add a semaphore which is waited by next Flush which submits command buffers
+	void AddWaitSemaphore(vk::Semaphore semaphore, vk::PipelineStageFlags stage);
+
+	//! add a semaphore which is signaled by next Flush which submits command buffers
+	void AddSignalSemaphore(vk::Semaphore semaphore);
+
+	/**
+		@brief	make commands which are enqueued after this call wait on gpu until a value is completed
+		@note
+		Without a timeline semaphore, cpu waits instead.
+	*/
+	void AddWaitValue(uint64_t value);
+
+	/**
+		@brief	submit all enqueued command buffers with one vkQueueSubmit
+		@note	nothing is submitted without enqueued command buffers, and added semaphores are kept for a next Flush
+		@return	a value which is completed when submitted commands are finished
+	*/
+	uint64_t Flush();
+
+	/**
+		@brief	get an error of a submission which failed since a previous call, and clear it
+		@note
+		A value of failed commands is completed without them, so waits for it do not block.
+	*/
+	vk::Result PopSubmitResult();
+
+	/**
+		@brief	present an image after flushed commands
+		@note
+		With the submission thread, it does not wait for a driver and returns an error of a previous present.
+		An error is returned instead of being thrown.
+	*/
+	vk::Result Present(vk::SwapchainKHR swapchain, uint32_t imageIndex, vk::Semaphore waitSemaphore);
+
+	/**
+		@brief	wait until presents which were requested are passed to the queue by the submission thread
+		@note
+		A swapchain must not be acquired while it is presented in the submission thread.
+		An acquisition may block until queued presents are processed, so the swapchain is not locked while acquiring.
+	*/
+	void WaitPresents();
+
+	//! it can be called in any thread and does not wait even if other threads are waiting
+	bool IsCompleted(uint64_t value);
+
+	/**
+		@brief	wait until a value is completed
+		@note
+		If the value is not submitted yet, enqueued command buffers are flushed.
+	*/
+	bool Wait(uint64_t value);
+
+	/**
+		@brief	wait until a value is completed for at most a timeout in nanoseconds
+		@note
+		It can be called in any thread because enqueued command buffers are not flushed.
+		It fails if the value is not flushed and completed within the timeout.
+	*/
+	bool WaitFor(uint64_t value, uint64_t timeout);
+
+	//! flush and wait until all commands are finished and the submission thread is idle
+	void WaitIdle();
+
+	//! the number of command buffers which have been enqueued
+	uint64_t GetEnqueuedCount() const { return enqueuedCount_; }
+
+	//! it can be called in any thread
+	uint64_t GetSubmittedValue() const { return submittedValue_.load(); }
+
+	uint64_t GetCompletedValue() const { return completedValue_.load(); }
+
+	bool GetIsTimelineSemaphoreEnabled() const { return static_cast<bool>(timelineSemaphore_); }
+
+	bool GetIsSubmissionThreadEnabled() const { return submissionThread_.joinable(); }
+
+	vk::Queue GetQueue() const { return queue_; }
+};
+
+} // namespace LLGI
@@ -45,10 +45,10 @@ bool ConstantBufferVulkan::InitializeAsShortTime(GraphicsVulkan* graphics, Singl
 		buffer_ = std::unique_ptr<Buffer>(new Buffer(graphics_.get()));
 	}
 
-	auto alignedSize = static_cast<int32_t>(GetAlignedSize(size, 256));
+	// the pool packs buffers with an alignment of the device
 	VkBuffer buffer;
 	VkDeviceMemory deviceMemory;
-	if (memoryPool->GetConstantBuffer(alignedSize, &buffer, &deviceMemory, &offset_))
+	if (memoryPool->GetConstantBuffer(size, &buffer, &deviceMemory, &offset_, &mappedData_))
 	{
 		buffer_->Attach(vk::Buffer(buffer), vk::DeviceMemory(deviceMemory), true);
 		memSize_ = size;
@@ -62,17 +62,66 @@ bool ConstantBufferVulkan::InitializeAsShortTime(GraphicsVulkan* graphics, Singl
 
 void* ConstantBufferVulkan::Lock()
 {
+	if (mappedData_ != nullptr)
+	{
+		data = mappedData_;
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(buffer_->devMem(), offset_, memSize_, vk::MemoryMapFlags());
 	return data;
 }
 
 void* ConstantBufferVulkan::Lock(int32_t offset, int32_t size)
 {
+	if (mappedData_ != nullptr)
+	{
+		data = static_cast<uint8_t*>(mappedData_) + offset;
+		return data;
+	}
+
 	data = graphics_->GetDevice().mapMemory(buffer_->devMem(), offset_ + offset, size, vk::MemoryMapFlags());
 	return data;
 }
 
-void ConstantBufferVulkan::Unlock() { graphics_->GetDevice().unmapMemory(buffer_->devMem()); }
+void* ConstantBufferVulkan::Lock(LockMode mode)
+{
+	// memory in a pool is not read by gpu in this frame
+	if (mode != LockMode::Discard || mappedData_ != nullptr)
+	{
+		return Lock();
+	}
+
+	// a current buffer may be read by gpu, so it is replaced with a buffer which gpu finished reading
+	auto buffer = discardedBuffers_.Pop(graphics_.get());
+	if (buffer == nullptr)
+	{
+		buffer = std::unique_ptr<Buffer>(new Buffer(graphics_.get()));
+		if (!CreateMappableBuffer(graphics_.get(),
+								  GetAlignedSize(memSize_, 256),
+								  vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst,
+								  *buffer))
+		{
+			return nullptr;
+		}
+	}
+
+	discardedBuffers_.Push(graphics_.get(), std::move(buffer_), true);
+	buffer_ = std::move(buffer);
+
+	return Lock();
+}
+
+void ConstantBufferVulkan::Unlock()
+{
+	// memory in a pool is coherent and kept mapped
+	if (mappedData_ != nullptr)
+	{
+		return;
+	}
+
+	graphics_->GetDevice().unmapMemory(buffer_->devMem());
+}
 
 int32_t ConstantBufferVulkan::GetSize() { return memSize_; }
 
@@ -18,6 +18,12 @@ private:
 	void* data = nullptr;
 	int32_t offset_ = 0;
 
+	//! a persistently mapped pointer if it is allocated from a memory pool
+	void* mappedData_ = nullptr;
+
+	//! previous buffers which were replaced by Lock(LockMode::Discard)
+	DiscardedBuffersVulkan discardedBuffers_;
+
 public:
 	ConstantBufferVulkan();
 	~ConstantBufferVulkan() override;
@@ -27,6 +33,7 @@ public:
 
 	void* Lock() override;
 	void* Lock(int32_t offset, int32_t size) override;
+	void* Lock(LockMode mode) override;
 	void Unlock() override;
 	int32_t GetSize() override;
 	int32_t GetOffset() const { return offset_; }
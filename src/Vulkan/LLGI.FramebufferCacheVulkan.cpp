@@ -0,0 +1,173 @@
+#include "LLGI.FramebufferCacheVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
+#include "LLGI.TextureVulkan.h"
+
+namespace LLGI
+{
+
+bool FramebufferCacheVulkan::Key::operator==(const Key& value) const
+{
+	if (!(RenderPassKey == value.RenderPassKey))
+		return false;
+
+	if (Size.X != value.Size.X || Size.Y != value.Size.Y)
+		return false;
+
+	if (Views.size() != value.Views.size())
+		return false;
+
+	for (size_t i = 0; i < Views.size(); i++)
+	{
+		if (Views.at(i) != value.Views.at(i))
+			return false;
+	}
+
+	return true;
+}
+
+std::size_t FramebufferCacheVulkan::Key::Hash::operator()(const Key& key) const
+{
+	auto ret = RenderPassPipelineStateKey::Hash()(key.RenderPassKey);
+	ret += std::hash<int32_t>()(key.Size.X) * 31 + std::hash<int32_t>()(key.Size.Y);
+
+	for (size_t i = 0; i < key.Views.size(); i++)
+	{
+		ret = ret * 31 + std::hash<VkImageView>()(static_cast<VkImageView>(key.Views.at(i)));
+	}
+
+	return ret;
+}
+
+FramebufferCacheVulkan::FramebufferCacheVulkan(vk::Device device, CommandQueueVulkan* commandQueue)
+	: device_(device), commandQueue_(commandQueue)
+{
+	SafeAddRef(commandQueue_);
+}
+
+FramebufferCacheVulkan::~FramebufferCacheVulkan()
+{
+	Clear();
+	SafeRelease(commandQueue_);
+}
+
+void FramebufferCacheVulkan::DestroyEvictedFramebuffers(bool isForced)
+{
+	// values are not sorted because textures are destroyed in any thread
+	for (auto it = evictedFramebuffers_.begin(); it != evictedFramebuffers_.end();)
+	{
+		if (!isForced && commandQueue_ != nullptr && !commandQueue_->IsCompleted(it->first))
+		{
+			it++;
+			continue;
+		}
+
+		device_.destroyFramebuffer(it->second);
+		it = evictedFramebuffers_.erase(it);
+	}
+}
+
+vk::Framebuffer FramebufferCacheVulkan::Get(const Key& key, vk::RenderPass renderPass, TextureVulkan* const* textures, int32_t textureCount)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		DestroyEvictedFramebuffers(false);
+
+		auto it = framebuffers_.find(key);
+		if (it != framebuffers_.end())
+		{
+			return it->second;
+		}
+	}
+
+	vk::FramebufferCreateInfo framebufferCreateInfo;
+	framebufferCreateInfo.renderPass = renderPass;
+	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(key.Views.size());
+	framebufferCreateInfo.pAttachments = key.Views.data();
+	framebufferCreateInfo.width = key.Size.X;
+	framebufferCreateInfo.height = key.Size.Y;
+	framebufferCreateInfo.layers = 1;
+
+	auto framebuffer = device_.createFramebuffer(framebufferCreateInfo);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// another thread may create same one
+		auto it = framebuffers_.find(key);
+		if (it != framebuffers_.end())
+		{
+			device_.destroyFramebuffer(framebuffer);
+			return it->second;
+		}
+
+		framebuffers_[key] = framebuffer;
+	}
+
+	for (int32_t i = 0; i < textureCount; i++)
+	{
+		textures[i]->AddFramebufferCache(shared_from_this());
+	}
+
+	return framebuffer;
+}
+
+void FramebufferCacheVulkan::Evict(vk::ImageView view)
+{
+	// commands which use framebuffers may be executed and not flushed yet
+	const auto value = commandQueue_ != nullptr ? commandQueue_->GetSubmittedValue() + 1 : 0;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto it = framebuffers_.begin(); it != framebuffers_.end();)
+	{
+		const auto& views = it->first.Views;
+		bool isUsed = false;
+		for (size_t i = 0; i < views.size(); i++)
+		{
+			if (views.at(i) == view)
+			{
+				isUsed = true;
+				break;
+			}
+		}
+
+		if (isUsed)
+		{
+			evictedFramebuffers_.push_back(std::make_pair(value, it->second));
+			it = framebuffers_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	DestroyEvictedFramebuffers(false);
+}
+
+void FramebufferCacheVulkan::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto& it : framebuffers_)
+	{
+		device_.destroyFramebuffer(it.second);
+	}
+	framebuffers_.clear();
+
+	DestroyEvictedFramebuffers(true);
+}
+
+size_t FramebufferCacheVulkan::GetCount()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return framebuffers_.size();
+}
+
+size_t FramebufferCacheVulkan::GetEvictedCount()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return evictedFramebuffers_.size();
+}
+
+} // namespace LLGI
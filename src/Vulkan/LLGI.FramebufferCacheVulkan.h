@@ -0,0 +1,76 @@
+
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "../Utils/LLGI.FixedSizeVector.h"
+#include "LLGI.BaseVulkan.h"
+#include <memory>
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	framebuffers which are shared among render passes with same attachments
+	@note
+	A framebuffer is kept until one of its attachments is destroyed, so that creating a render pass every frame is cheap.
+	Textures refer this cache weakly and evict framebuffers from any thread when they are destroyed.
+	Evicted framebuffers are destroyed after commands which were executed before the eviction are finished.
+*/
+class FramebufferCacheVulkan : public std::enable_shared_from_this<FramebufferCacheVulkan>
+{
+public:
+	struct Key
+	{
+		RenderPassPipelineStateKey RenderPassKey;
+		FixedSizeVector<vk::ImageView, RenderTargetMax + 2> Views;
+		Vec2I Size;
+
+		bool operator==(const Key& value) const;
+
+		struct Hash
+		{
+			std::size_t operator()(const Key& key) const;
+		};
+	};
+
+private:
+	vk::Device device_;
+	CommandQueueVulkan* commandQueue_ = nullptr;
+	std::mutex mutex_;
+	std::unordered_map<Key, vk::Framebuffer, Key::Hash> framebuffers_;
+
+	//! evicted framebuffers with values of the command queue which are completed when gpu does not use them
+	std::vector<std::pair<uint64_t, vk::Framebuffer>> evictedFramebuffers_;
+
+	//! destroy evicted framebuffers which gpu does not use, mutex_ must be locked
+	void DestroyEvictedFramebuffers(bool isForced);
+
+public:
+	/**
+		@param	commandQueue	a queue which is used to defer destroying framebuffers, they are destroyed soon without it
+	*/
+	FramebufferCacheVulkan(vk::Device device, CommandQueueVulkan* commandQueue = nullptr);
+	~FramebufferCacheVulkan();
+
+	/**
+		@brief	get a framebuffer, it is created if it does not exist
+		@param	renderPass	a render pass which the framebuffer is created with, it must be compatible with key.RenderPassKey
+		@param	textures	attachments which views are specified in key.Views
+	*/
+	vk::Framebuffer Get(const Key& key, vk::RenderPass renderPass, TextureVulkan* const* textures, int32_t textureCount);
+
+	//! remove framebuffers which have the view, they are destroyed after gpu finishes using them
+	void Evict(vk::ImageView view);
+
+	//! destroy all framebuffers, gpu must be idle
+	void Clear();
+
+	//! the number of cached framebuffers
+	size_t GetCount();
+
+	//! the number of evicted framebuffers which wait for gpu to be destroyed
+	size_t GetEvictedCount();
+};
+
+} // namespace LLGI
@@ -19,43 +19,176 @@ GraphicsVulkan::GraphicsVulkan(const vk::Device& device,
 							   int32_t swapBufferCount,
 							   std::function<void(vk::CommandBuffer, vk::Fence)> addCommand,
 							   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache,
-							   ReferenceObject* owner)
+							   ReferenceObject* owner,
+							   std::function<uint64_t()> getPresentedFrameCount,
+							   CommandQueueVulkan* commandQueue,
+							   int32_t queueFamilyIndex)
 	: vkDevice_(device)
 	, vkQueue_(quque)
 	, vkCmdPool_(commandPool)
+	, queueFamilyIndex_(queueFamilyIndex)
 	, vkPysicalDevice_(pysicalDevice)
 	, addCommand_(addCommand)
+	, commandQueue_(commandQueue)
 	, renderPassPipelineStateCache_(renderPassPipelineStateCache)
 	, owner_(owner)
+	, getPresentedFrameCount_(getPresentedFrameCount)
 {
 	SafeAddRef(owner_);
+	SafeAddRef(commandQueue_);
 
 	swapBufferCount_ = swapBufferCount;
 
 	SafeAddRef(renderPassPipelineStateCache_);
 	if (renderPassPipelineStateCache_ == nullptr)
 	{
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(device, nullptr);
+		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(device, nullptr, false, false, commandQueue_);
+	}
+
+	// check whether device local memory is visible from cpu
+	// a small visible heap on a discrete gpu (BAR) is not treated as unified memory
+	vkMemoryProperties_ = vkPysicalDevice_.getMemoryProperties();
+	auto deviceProperties = vkPysicalDevice_.getProperties();
+	auto deviceType = deviceProperties.deviceType;
+
+	constantBufferAlignment_ = std::max(static_cast<int32_t>(deviceProperties.limits.minUniformBufferOffsetAlignment), 1);
+
+	readbackBufferPool_ = std::make_shared<ReadbackBufferPoolVulkan>(this);
+	transientRenderTexturePool_ = std::unique_ptr<TransientRenderTexturePoolVulkan>(new TransientRenderTexturePoolVulkan(this));
+
+	vk::DeviceSize maxDeviceLocalHeapSize = 0;
+	for (uint32_t i = 0; i < vkMemoryProperties_.memoryHeapCount; i++)
+	{
+		if (vkMemoryProperties_.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+		{
+			maxDeviceLocalHeapSize = std::max(maxDeviceLocalHeapSize, vkMemoryProperties_.memoryHeaps[i].size);
+		}
+	}
+
+	const auto unifiedFlags =
+		vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+	for (uint32_t i = 0; i < vkMemoryProperties_.memoryTypeCount; i++)
+	{
+		const auto& memoryType = vkMemoryProperties_.memoryTypes[i];
+		if ((memoryType.propertyFlags & unifiedFlags) != unifiedFlags)
+			continue;
+
+		if (deviceType == vk::PhysicalDeviceType::eIntegratedGpu || deviceType == vk::PhysicalDeviceType::eCpu ||
+			vkMemoryProperties_.memoryHeaps[memoryType.heapIndex].size == maxDeviceLocalHeapSize)
+		{
+			isUnifiedMemory_ = true;
+			break;
+		}
 	}
 }
 
 GraphicsVulkan::~GraphicsVulkan()
 {
+	// buffers may be written by gpu
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->WaitIdle();
+	}
+	readbackBufferPool_.reset();
+	transientRenderTexturePool_.reset();
+	FreeCompletedSingleTimeCommands();
+
 	SafeRelease(renderPassPipelineStateCache_);
 
+	SafeRelease(commandQueue_);
+
 	SafeRelease(owner_);
 }
 
 void GraphicsVulkan::SetWindowSize(const Vec2I& windowSize) { throw "Not inplemented"; }
 
-void GraphicsVulkan::Execute(CommandList* commandList)
+SyncPoint GraphicsVulkan::Execute(CommandList* commandList)
 {
 	auto commandList_ = static_cast<CommandListVulkan*>(commandList);
 	auto cmdBuf = commandList_->GetCommandBuffer();
+
+	// layouts are resolved in an order of execution, which may differ from an order of recording
+	// commands which are executed now are submitted with the next value
+	const auto queueValue = commandQueue_ != nullptr ? commandQueue_->GetSubmittedValue() + 1 : 0;
+	auto fixupCmdBuf = commandList_->ResolveImageLayouts(queueValue);
+
+	if (commandQueue_ != nullptr)
+	{
+		if (fixupCmdBuf)
+		{
+			commandQueue_->Enqueue(fixupCmdBuf);
+		}
+
+		// commands are submitted together in Flush
+		SyncPoint syncPoint;
+		syncPoint.Value = commandQueue_->Enqueue(cmdBuf);
+		commandList_->SetSubmittedValue(syncPoint.Value);
+		return syncPoint;
+	}
+
+	if (fixupCmdBuf)
+	{
+		addCommand_(fixupCmdBuf, vk::Fence());
+	}
+
 	addCommand_(cmdBuf, commandList_->GetFence());
+	return SyncPoint();
 }
 
-void GraphicsVulkan::WaitFinish() { vkQueue_.waitIdle(); }
+void GraphicsVulkan::Flush()
+{
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->Flush();
+	}
+}
+
+bool GraphicsVulkan::Wait(const SyncPoint& syncPoint)
+{
+	if (commandQueue_ == nullptr || !syncPoint.IsValid())
+	{
+		return Graphics::Wait(syncPoint);
+	}
+
+	return commandQueue_->Wait(syncPoint.Value);
+}
+
+bool GraphicsVulkan::IsCompleted(const SyncPoint& syncPoint)
+{
+	if (commandQueue_ == nullptr || !syncPoint.IsValid())
+	{
+		return Graphics::IsCompleted(syncPoint);
+	}
+
+	return commandQueue_->IsCompleted(syncPoint.Value);
+}
+
+void GraphicsVulkan::WaitOnGPU(const SyncPoint& syncPoint)
+{
+	if (commandQueue_ == nullptr || !syncPoint.IsValid())
+	{
+		return;
+	}
+
+	commandQueue_->AddWaitValue(syncPoint.Value);
+}
+
+void GraphicsVulkan::WaitFinish()
+{
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->WaitIdle();
+	}
+	else
+	{
+		vkQueue_.waitIdle();
+	}
+
+	FreeCompletedSingleTimeCommands();
+
+	waitFinishCount_++;
+}
 
 VertexBuffer* GraphicsVulkan::CreateVertexBuffer(int32_t size)
 {
@@ -138,8 +271,9 @@ ConstantBuffer* GraphicsVulkan::CreateConstantBuffer(int32_t size)
 
 RenderPass* GraphicsVulkan::CreateRenderPass(Texture** textures, int32_t textureCount, Texture* depthTexture)
 {
-	assert(textures != nullptr);
-	if (textures == nullptr)
+	// textures may be null in a depth only pass
+	assert(textures != nullptr || textureCount == 0);
+	if (textures == nullptr && textureCount > 0)
 		return nullptr;
 
 	for (int32_t i = 0; i < textureCount; i++)
@@ -219,6 +353,27 @@ Texture* GraphicsVulkan::CreateRenderTexture(const RenderTextureInitializationPa
 	return obj;
 }
 
+Texture* GraphicsVulkan::AcquireTransientRenderTexture(const RenderTextureInitializationParameter& parameter)
+{
+	return transientRenderTexturePool_->Acquire(parameter);
+}
+
+void GraphicsVulkan::EndTransientRenderTextureFrame() { transientRenderTexturePool_->EndFrame(); }
+
+TransientRenderTexturePoolStatistics GraphicsVulkan::GetTransientRenderTexturePoolStatistics() const
+{
+	return transientRenderTexturePool_->GetStatistics();
+}
+
+FramebufferCacheStatistics GraphicsVulkan::GetFramebufferCacheStatistics() const
+{
+	FramebufferCacheStatistics statistics;
+	auto cache = renderPassPipelineStateCache_->GetFramebufferCache();
+	statistics.FramebufferCount = static_cast<int32_t>(cache->GetCount());
+	statistics.EvictedFramebufferCount = static_cast<int32_t>(cache->GetEvictedCount());
+	return statistics;
+}
+
 Texture* GraphicsVulkan::CreateDepthTexture(const DepthTextureInitializationParameter& parameter)
 {
 	auto obj = new TextureVulkan();
@@ -252,6 +407,12 @@ std::vector<uint8_t> GraphicsVulkan::CaptureRenderTarget(Texture* renderTarget)
 
 	std::vector<uint8_t> result;
 	VkDevice device = static_cast<VkDevice>(GetDevice());
+
+	// the submission thread must not use the queue while the device is waited
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->WaitIdle();
+	}
 	vkDeviceWaitIdle(device);
 
 	auto texture = static_cast<TextureVulkan*>(renderTarget);
@@ -375,13 +536,88 @@ RenderPassPipelineState* GraphicsVulkan::CreateRenderPassPipelineState(const Ren
 	return renderPassPipelineStateCache_->Create(key);
 }
 
+bool GraphicsVulkan::IsResolvedDepthSupported() const { return renderPassPipelineStateCache_->GetIsDepthResolveEnabled(); }
+
 int32_t GraphicsVulkan::GetSwapBufferCount() const { return swapBufferCount_; }
 
+GPUTimeStampVulkan GraphicsVulkan::GetTimeStamp() const
+{
+	GPUTimeStampVulkan timeStamp;
+	timeStamp.PresentedFrameCount = getPresentedFrameCount_ != nullptr ? getPresentedFrameCount_() : 0;
+	timeStamp.WaitFinishCount = waitFinishCount_;
+
+	// commands which are executed now are submitted with the next value
+	if (commandQueue_ != nullptr)
+	{
+		timeStamp.QueueValue = commandQueue_->GetSubmittedValue() + 1;
+	}
+	return timeStamp;
+}
+
+bool GraphicsVulkan::GetIsCompleted(const GPUTimeStampVulkan& timeStamp) const
+{
+	if (timeStamp.WaitFinishCount < waitFinishCount_)
+	{
+		return true;
+	}
+
+	// it is tracked without presenting, such as an offscreen loop
+	if (commandQueue_ != nullptr && timeStamp.QueueValue > 0)
+	{
+		return commandQueue_->IsCompleted(timeStamp.QueueValue);
+	}
+
+	// a platform keeps commands of frames in flight at most
+	if (getPresentedFrameCount_ != nullptr)
+	{
+		return timeStamp.PresentedFrameCount + swapBufferCount_ <= getPresentedFrameCount_();
+	}
+
+	return false;
+}
+
 uint32_t GraphicsVulkan::GetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties)
 {
 	return LLGI::GetMemoryTypeIndex(vkPysicalDevice_, bits, properties);
 }
 
+bool GraphicsVulkan::TryGetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties, uint32_t& index) const
+{
+	for (uint32_t i = 0; i < vkMemoryProperties_.memoryTypeCount; i++)
+	{
+		if ((bits & (1u << i)) != 0 && (vkMemoryProperties_.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			index = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool GraphicsVulkan::SubmitAndWait(vk::CommandBuffer commandBuffer)
+{
+	// keep an order with command lists which are not submitted yet
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->Enqueue(commandBuffer);
+		commandQueue_->WaitIdle();
+		return true;
+	}
+
+	VkCommandBuffer nativeCommandBuffer = static_cast<VkCommandBuffer>(commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &nativeCommandBuffer;
+
+	LLGI_VK_CHECK(vkQueueSubmit(static_cast<VkQueue>(vkQueue_), 1, &submitInfo, VK_NULL_HANDLE));
+	LLGI_VK_CHECK(vkQueueWaitIdle(static_cast<VkQueue>(vkQueue_)));
+
+	return true;
+}
+
 VkCommandBuffer GraphicsVulkan::BeginSingleTimeCommands()
 {
 	VkCommandBufferAllocateInfo allocInfo = {};
@@ -402,17 +638,43 @@ VkCommandBuffer GraphicsVulkan::BeginSingleTimeCommands()
 	return commandBuffer;
 }
 
-bool GraphicsVulkan::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
+void GraphicsVulkan::FreeCompletedSingleTimeCommands()
+{
+	auto it = enqueuedSingleTimeCommands_.begin();
+	while (it != enqueuedSingleTimeCommands_.end() && commandQueue_->IsCompleted(it->first))
+	{
+		vkDevice_.freeCommandBuffers(vkCmdPool_, it->second);
+		++it;
+	}
+
+	enqueuedSingleTimeCommands_.erase(enqueuedSingleTimeCommands_.begin(), it);
+}
+
+uint64_t GraphicsVulkan::EnqueueSingleTimeCommands(VkCommandBuffer commandBuffer)
 {
+	if (commandQueue_ == nullptr)
+	{
+		EndSingleTimeCommands(commandBuffer);
+		return 0;
+	}
+
 	vkEndCommandBuffer(commandBuffer);
 
-	VkSubmitInfo submitInfo = {};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffer;
+	// it is submitted with the next flush before command lists which are executed after it
+	FreeCompletedSingleTimeCommands();
+	const auto value = commandQueue_->Enqueue(vk::CommandBuffer(commandBuffer));
+	enqueuedSingleTimeCommands_.emplace_back(value, vk::CommandBuffer(commandBuffer));
+	return value;
+}
 
-	LLGI_VK_CHECK(vkQueueSubmit(static_cast<VkQueue>(vkQueue_), 1, &submitInfo, VK_NULL_HANDLE));
-	LLGI_VK_CHECK(vkQueueWaitIdle(static_cast<VkQueue>(vkQueue_)));
+bool GraphicsVulkan::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
+{
+	vkEndCommandBuffer(commandBuffer);
+
+	if (!SubmitAndWait(vk::CommandBuffer(commandBuffer)))
+	{
+		return false;
+	}
 
 	vkFreeCommandBuffers(static_cast<VkDevice>(GetDevice()), static_cast<VkCommandPool>(GetCommandPool()), 1, &commandBuffer);
 
@@ -2,9 +2,13 @@
 
 #include "../LLGI.Graphics.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
+#include "LLGI.ReadbackVulkan.h"
 #include "LLGI.RenderPassPipelineStateCacheVulkan.h"
 #include "LLGI.RenderPassVulkan.h"
+#include "LLGI.TransientRenderTexturePoolVulkan.h"
 #include <functional>
+#include <memory>
 #include <unordered_map>
 
 namespace LLGI
@@ -22,12 +26,28 @@ private:
 	vk::Device vkDevice_;
 	vk::Queue vkQueue_;
 	vk::CommandPool vkCmdPool_;
+	int32_t queueFamilyIndex_ = 0;
 	vk::PhysicalDevice vkPysicalDevice_;
+	vk::PhysicalDeviceMemoryProperties vkMemoryProperties_;
+	bool isUnifiedMemory_ = false;
+	int32_t constantBufferAlignment_ = 256;
 
 	std::function<void(vk::CommandBuffer, vk::Fence)> addCommand_;
+	CommandQueueVulkan* commandQueue_ = nullptr;
 	RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache_ = nullptr;
 	ReferenceObject* owner_ = nullptr;
 
+	std::function<uint64_t()> getPresentedFrameCount_;
+	uint64_t waitFinishCount_ = 0;
+
+	std::shared_ptr<ReadbackBufferPoolVulkan> readbackBufferPool_;
+	std::unique_ptr<TransientRenderTexturePoolVulkan> transientRenderTexturePool_;
+
+	//! command buffers which were enqueued without waiting, with values of a command queue, they are freed after gpu finishes them
+	std::vector<std::pair<uint64_t, vk::CommandBuffer>> enqueuedSingleTimeCommands_;
+
+	void FreeCompletedSingleTimeCommands();
+
 public:
 	GraphicsVulkan(const vk::Device& device,
 				   const vk::Queue& quque,
@@ -36,13 +56,24 @@ public:
 				   int32_t swapBufferCount,
 				   std::function<void(vk::CommandBuffer, vk::Fence)> addCommand,
 				   RenderPassPipelineStateCacheVulkan* renderPassPipelineStateCache = nullptr,
-				   ReferenceObject* owner = nullptr);
+				   ReferenceObject* owner = nullptr,
+				   std::function<uint64_t()> getPresentedFrameCount = nullptr,
+				   CommandQueueVulkan* commandQueue = nullptr,
+				   int32_t queueFamilyIndex = 0);
 
 	~GraphicsVulkan() override;
 
 	void SetWindowSize(const Vec2I& windowSize) override;
 
-	void Execute(CommandList* commandList) override;
+	SyncPoint Execute(CommandList* commandList) override;
+
+	void Flush() override;
+
+	bool Wait(const SyncPoint& syncPoint) override;
+
+	bool IsCompleted(const SyncPoint& syncPoint) override;
+
+	void WaitOnGPU(const SyncPoint& syncPoint) override;
 
 	void WaitFinish() override;
 
@@ -61,6 +92,14 @@ public:
 	Texture* CreateRenderTexture(const RenderTextureInitializationParameter& parameter) override;
 	Texture* CreateDepthTexture(const DepthTextureInitializationParameter& parameter) override;
 
+	Texture* AcquireTransientRenderTexture(const RenderTextureInitializationParameter& parameter) override;
+
+	void EndTransientRenderTextureFrame() override;
+
+	TransientRenderTexturePoolStatistics GetTransientRenderTexturePoolStatistics() const override;
+
+	FramebufferCacheStatistics GetFramebufferCacheStatistics() const override;
+
 	Texture* CreateTexture(uint64_t id) override;
 
 	std::vector<uint8_t> CaptureRenderTarget(Texture* renderTarget) override;
@@ -69,16 +108,75 @@ public:
 
 	RenderPassPipelineState* CreateRenderPassPipelineState(const RenderPassPipelineStateKey& key) override;
 
+	//! it is supported if a device supports Vulkan 1.2
+	bool IsResolvedDepthSupported() const override;
+
 	vk::PhysicalDevice GetPysicalDevice() const { return vkPysicalDevice_; }
 	vk::Device GetDevice() const { return vkDevice_; }
 	vk::CommandPool GetCommandPool() const { return vkCmdPool_; }
+
+	//! a queue family index to create command pools
+	int32_t GetQueueFamilyIndex() const { return queueFamilyIndex_; }
 	vk::Queue GetQueue() const { return vkQueue_; }
 
+	/**
+		@brief	get a queue which batches submissions
+		@note
+		If it is null, commands are submitted immediately in Execute.
+	*/
+	CommandQueueVulkan* GetCommandQueue() const { return commandQueue_; }
+
+	/**
+		@brief	submit a command buffer after executed commands and wait until it is finished
+	*/
+	bool SubmitAndWait(vk::CommandBuffer commandBuffer);
+
+	//! the number of frames in flight, which resources for each frame are allocated with, not the number of swapchain images
 	int32_t GetSwapBufferCount() const;
 	uint32_t GetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties);
 
+	/**
+		@brief	find a memory type without asserting
+		@return	whether a memory type is found
+	*/
+	bool TryGetMemoryTypeIndex(uint32_t bits, const vk::MemoryPropertyFlags& properties, uint32_t& index) const;
+
+	//! buffers for CommandList::ReadbackTexture
+	std::shared_ptr<ReadbackBufferPoolVulkan> GetReadbackBufferPool() const { return readbackBufferPool_; }
+
+	/**
+		@brief	whether device local memory can be mapped by cpu (integrated gpu or software renderer)
+		@note
+		If it is true, buffers and textures are written directly without a staging copy.
+	*/
+	bool GetIsUnifiedMemory() const { return isUnifiedMemory_; }
+
+	//! an alignment of an offset of a constant buffer in a shared buffer (minUniformBufferOffsetAlignment)
+	int32_t GetConstantBufferAlignment() const { return constantBufferAlignment_; }
+
+	/**
+		@brief	get a time stamp to check later whether gpu finished commands which were executed until now
+	*/
+	GPUTimeStampVulkan GetTimeStamp() const;
+
+	/**
+		@brief	whether gpu finished commands which were executed until the time stamp
+		@note
+		It is tracked by values of a command queue. Without a queue, it is tracked by presented frames or calls of WaitFinish.
+		Commands which were recorded before the time stamp must be executed before the next flush.
+	*/
+	bool GetIsCompleted(const GPUTimeStampVulkan& timeStamp) const;
+
 	VkCommandBuffer BeginSingleTimeCommands();
 	bool EndSingleTimeCommands(VkCommandBuffer commandBuffer);
+
+	/**
+		@brief	end a command buffer from BeginSingleTimeCommands and submit it after executed commands without waiting
+		@note
+		It waits like EndSingleTimeCommands without a command queue.
+		@return	a value of a command queue which is completed when gpu finishes it, 0 if it is finished already
+	*/
+	uint64_t EnqueueSingleTimeCommands(VkCommandBuffer commandBuffer);
 };
 
 } // namespace LLGI
@@ -0,0 +1,168 @@
+#include "LLGI.ImageLayoutTrackerVulkan.h"
+#include "LLGI.TextureVulkan.h"
+
+namespace LLGI
+{
+
+ImageLayoutTrackerVulkan::~ImageLayoutTrackerVulkan() { Reset(); }
+
+std::vector<ImageLayoutTrackerVulkan::MipState>& ImageLayoutTrackerVulkan::GetStates(TextureVulkan* texture)
+{
+	auto it = states_.find(texture);
+	if (it != states_.end())
+	{
+		return it->second;
+	}
+
+	SafeAddRef(texture);
+	auto& states = states_[texture];
+	states.resize(texture->GetMipmapCount());
+	return states;
+}
+
+void ImageLayoutTrackerVulkan::Transition(BarrierBatcherVulkan& batcher,
+										  TextureVulkan* texture,
+										  int32_t baseMipLevel,
+										  int32_t mipLevelCount,
+										  vk::ImageLayout layout,
+										  bool isDiscarded)
+{
+	auto& states = GetStates(texture);
+	const auto end = baseMipLevel + mipLevelCount;
+
+	int32_t begin = baseMipLevel;
+	while (begin < end)
+	{
+		auto& state = states[begin];
+
+		// a layout before commands is unknown until they are executed
+		if (!state.isUsed)
+		{
+			state.isUsed = true;
+			state.isInitialRequired = true;
+			state.isDiscarded = isDiscarded;
+			state.initialLayout = layout;
+			state.currentLayout = layout;
+			begin++;
+			continue;
+		}
+
+		int32_t next = begin + 1;
+		while (next < end && states[next].isUsed && states[next].currentLayout == state.currentLayout)
+		{
+			next++;
+		}
+
+		if (state.currentLayout != layout || isDiscarded)
+		{
+			auto subresourceRange = texture->GetSubresourceRange();
+			subresourceRange.baseMipLevel = begin;
+			subresourceRange.levelCount = next - begin;
+			batcher.AddImageBarrier(texture->GetImage(), subresourceRange, state.currentLayout, layout, isDiscarded);
+
+			for (int32_t i = begin; i < next; i++)
+			{
+				states[i].currentLayout = layout;
+			}
+		}
+
+		begin = next;
+	}
+}
+
+void ImageLayoutTrackerVulkan::Transition(BarrierBatcherVulkan& batcher, TextureVulkan* texture, vk::ImageLayout layout, bool isDiscarded)
+{
+	Transition(batcher, texture, 0, texture->GetMipmapCount(), layout, isDiscarded);
+}
+
+void ImageLayoutTrackerVulkan::Transition(BarrierBatcherVulkan& batcher, TextureVulkan* texture, int32_t mipLevel, vk::ImageLayout layout)
+{
+	Transition(batcher, texture, mipLevel, 1, layout, false);
+}
+
+void ImageLayoutTrackerVulkan::Use(TextureVulkan* texture) { GetStates(texture); }
+
+void ImageLayoutTrackerVulkan::SetLayout(TextureVulkan* texture, vk::ImageLayout layout)
+{
+	for (auto& state : GetStates(texture))
+	{
+		state.isUsed = true;
+		state.currentLayout = layout;
+	}
+}
+
+bool ImageLayoutTrackerVulkan::TryGetLayout(TextureVulkan* texture, int32_t mipLevel, vk::ImageLayout& layout) const
+{
+	auto it = states_.find(texture);
+	if (it == states_.end() || !it->second[mipLevel].isUsed)
+	{
+		return false;
+	}
+
+	layout = it->second[mipLevel].currentLayout;
+	return true;
+}
+
+void ImageLayoutTrackerVulkan::Resolve(BarrierBatcherVulkan& batcher, uint64_t queueValue)
+{
+	for (auto& pair : states_)
+	{
+		auto texture = pair.first;
+		const auto& states = pair.second;
+		const auto layouts = texture->GetImageLayouts();
+
+		if (queueValue > 0)
+		{
+			texture->SetUsedQueueValue(queueValue);
+		}
+
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			const auto& state = states[i];
+			if (!state.isUsed)
+			{
+				continue;
+			}
+
+			if (state.isInitialRequired && (layouts[i] != state.initialLayout || state.isDiscarded))
+			{
+				auto subresourceRange = texture->GetSubresourceRange();
+				subresourceRange.baseMipLevel = static_cast<uint32_t>(i);
+				subresourceRange.levelCount = 1;
+				batcher.AddImageBarrier(texture->GetImage(), subresourceRange, layouts[i], state.initialLayout, state.isDiscarded);
+			}
+
+			texture->ChangeImageLayout(static_cast<int32_t>(i), state.currentLayout);
+		}
+	}
+
+	Reset();
+}
+
+void ImageLayoutTrackerVulkan::Resolve()
+{
+	for (auto& pair : states_)
+	{
+		const auto& states = pair.second;
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			if (states[i].isUsed)
+			{
+				pair.first->ChangeImageLayout(static_cast<int32_t>(i), states[i].currentLayout);
+			}
+		}
+	}
+
+	Reset();
+}
+
+void ImageLayoutTrackerVulkan::Reset()
+{
+	for (auto& pair : states_)
+	{
+		pair.first->Release();
+	}
+	states_.clear();
+}
+
+} // namespace LLGI
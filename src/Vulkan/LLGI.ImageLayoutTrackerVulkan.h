@@ -0,0 +1,86 @@
+#pragma once
+
+#include "LLGI.BaseVulkan.h"
+#include <unordered_map>
+
+namespace LLGI
+{
+
+/**
+	@brief	layouts of textures which are used in a command list
+	@note
+	Layouts in which textures are when a command list is executed are unknown while it is recorded,
+	because other command lists may be recorded in other threads or executed in a different order.
+	A first transition of each mip level is not recorded but kept as an expected layout,
+	and barriers from actual layouts into expected layouts are recorded when the command list is executed.
+	Layouts of textures themselves are changed only in Resolve.
+*/
+class ImageLayoutTrackerVulkan
+{
+private:
+	struct MipState
+	{
+		bool isUsed = false;
+
+		//! whether the mip level must be in initialLayout before commands
+		bool isInitialRequired = false;
+
+		//! whether contents before commands are not required
+		bool isDiscarded = false;
+
+		vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined;
+		vk::ImageLayout currentLayout = vk::ImageLayout::eUndefined;
+	};
+
+	//! textures are referenced until they are resolved
+	std::unordered_map<TextureVulkan*, std::vector<MipState>> states_;
+
+	std::vector<MipState>& GetStates(TextureVulkan* texture);
+
+	void Transition(BarrierBatcherVulkan& batcher,
+					TextureVulkan* texture,
+					int32_t baseMipLevel,
+					int32_t mipLevelCount,
+					vk::ImageLayout layout,
+					bool isDiscarded);
+
+public:
+	ImageLayoutTrackerVulkan() = default;
+	~ImageLayoutTrackerVulkan();
+
+	ImageLayoutTrackerVulkan(const ImageLayoutTrackerVulkan&) = delete;
+	ImageLayoutTrackerVulkan& operator=(const ImageLayoutTrackerVulkan&) = delete;
+
+	/**
+		@brief	transition all mip levels into a layout before a command
+		@note
+		Mip levels which are not used in this command list yet are transitioned in Resolve.
+	*/
+	void Transition(BarrierBatcherVulkan& batcher, TextureVulkan* texture, vk::ImageLayout layout, bool isDiscarded = false);
+
+	void Transition(BarrierBatcherVulkan& batcher, TextureVulkan* texture, int32_t mipLevel, vk::ImageLayout layout);
+
+	//! track a texture which is used without transitions, such as a sampled texture, so that its last use is recorded in Resolve
+	void Use(TextureVulkan* texture);
+
+	//! set layouts which are changed by commands themselves, such as final layouts of a render pass
+	void SetLayout(TextureVulkan* texture, vk::ImageLayout layout);
+
+	//! get a layout after recorded commands, it fails if the mip level is not used in this command list
+	bool TryGetLayout(TextureVulkan* texture, int32_t mipLevel, vk::ImageLayout& layout) const;
+
+	/**
+		@brief	add barriers from actual layouts into expected layouts and change layouts of textures
+		@note
+		It must be called in an order in which command lists are executed.
+		@param	queueValue	a value of a command queue with which commands are executed, it is set to used textures if it is not 0
+	*/
+	void Resolve(BarrierBatcherVulkan& batcher, uint64_t queueValue);
+
+	//! change layouts of textures without barriers, for commands which are submitted by others
+	void Resolve();
+
+	void Reset();
+};
+
+} // namespace LLGI
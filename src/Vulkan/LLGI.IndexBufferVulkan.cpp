@@ -1,4 +1,7 @@
 #include "LLGI.IndexBufferVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
+#include "LLGI.SingleFrameMemoryPoolVulkan.h"
+#include <string.h>
 
 namespace LLGI
 {
@@ -12,9 +15,16 @@ bool IndexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t stride, int
 	SafeAddRef(graphics);
 	graphics_ = CreateSharedPtr(graphics);
 
-	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
 	gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
 
+	// on unified memory, a buffer on gpu is written directly without a staging copy
+	if (CreateBufferOnUnifiedMemory(graphics, memSize, vk::BufferUsageFlagBits::eIndexBuffer, *gpuBuf))
+	{
+		return true;
+	}
+
+	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics));
+
 	// create a buffer on cpu
 	{
 		vk::BufferCreateInfo IndexBufferInfo;
@@ -52,24 +62,142 @@ bool IndexBufferVulkan::Initialize(GraphicsVulkan* graphics, int32_t stride, int
 	return true;
 }
 
+bool IndexBufferVulkan::InitializeAsShortTime(GraphicsVulkan* graphics, SingleFrameMemoryPoolVulkan* memoryPool, int32_t stride, int32_t count)
+{
+	if (gpuBuf == nullptr)
+	{
+		SafeAddRef(graphics);
+		graphics_ = CreateSharedPtr(graphics);
+		gpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_.get()));
+	}
+
+	VkBuffer buffer;
+	VkDeviceMemory deviceMemory;
+	if (memoryPool->GetGeometryBuffer(stride * count, &buffer, &deviceMemory, &offset_, &mappedData_))
+	{
+		gpuBuf->Attach(vk::Buffer(buffer), vk::DeviceMemory(deviceMemory), true);
+		stride_ = stride;
+		count_ = count;
+		memSize = stride * count;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
 IndexBufferVulkan::IndexBufferVulkan() {}
 
 IndexBufferVulkan ::~IndexBufferVulkan() {}
 
+void IndexBufferVulkan::RenameIfUsed()
+{
+	// commands which are recorded and not executed yet read written data as before
+	auto commandQueue = graphics_->GetCommandQueue();
+	const auto usedValue = gpuBuf->GetUsedQueueValue();
+	if (cpuBuf != nullptr || commandQueue == nullptr || usedValue == 0 || commandQueue->IsCompleted(usedValue))
+	{
+		return;
+	}
+
+	auto buffer = discardedBuffers_.Pop(graphics_.get());
+	if (buffer == nullptr)
+	{
+		buffer = std::unique_ptr<Buffer>(new Buffer(graphics_.get()));
+		if (!CreateMappableBuffer(graphics_.get(), memSize, vk::BufferUsageFlagBits::eIndexBuffer, *buffer))
+		{
+			// it is written after gpu finishes reading if a new buffer cannot be created
+			commandQueue->Wait(usedValue);
+			return;
+		}
+	}
+
+	// contents are kept because only a part of a buffer may be written
+	auto device = graphics_->GetDevice();
+	auto src = device.mapMemory(gpuBuf->devMem(), 0, memSize, vk::MemoryMapFlags());
+	auto dst = device.mapMemory(buffer->devMem(), 0, memSize, vk::MemoryMapFlags());
+	memcpy(dst, src, memSize);
+	device.unmapMemory(buffer->devMem());
+	device.unmapMemory(gpuBuf->devMem());
+
+	discardedBuffers_.Push(graphics_.get(), std::move(gpuBuf), true);
+	gpuBuf = std::move(buffer);
+}
+
 void* IndexBufferVulkan::Lock()
 {
-	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), 0, memSize, vk::MemoryMapFlags());
+	if (mappedData_ != nullptr)
+	{
+		data = mappedData_;
+		return data;
+	}
+
+	// a buffer on unified memory is written in place, so it must not be read by gpu
+	RenameIfUsed();
+
+	auto& buf = cpuBuf != nullptr ? cpuBuf : gpuBuf;
+	data = graphics_->GetDevice().mapMemory(buf->devMem(), 0, memSize, vk::MemoryMapFlags());
 	return data;
 }
 
 void* IndexBufferVulkan::Lock(int32_t offset, int32_t size)
 {
-	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), offset, size, vk::MemoryMapFlags());
+	if (mappedData_ != nullptr)
+	{
+		data = static_cast<uint8_t*>(mappedData_) + offset;
+		return data;
+	}
+
+	RenameIfUsed();
+
+	auto& buf = cpuBuf != nullptr ? cpuBuf : gpuBuf;
+	data = graphics_->GetDevice().mapMemory(buf->devMem(), offset, size, vk::MemoryMapFlags());
 	return data;
 }
 
+void* IndexBufferVulkan::Lock(LockMode mode)
+{
+	// memory in a pool is not read by gpu in this frame
+	if (mode != LockMode::Discard || mappedData_ != nullptr)
+	{
+		return Lock();
+	}
+
+	// a current buffer may be read by gpu, so it is replaced with a buffer which gpu finished reading
+	// a buffer on device local memory is released because it cannot be mapped
+	auto buffer = discardedBuffers_.Pop(graphics_.get());
+	if (buffer == nullptr)
+	{
+		buffer = std::unique_ptr<Buffer>(new Buffer(graphics_.get()));
+		if (!CreateMappableBuffer(graphics_.get(), memSize, vk::BufferUsageFlagBits::eIndexBuffer, *buffer))
+		{
+			return nullptr;
+		}
+	}
+
+	discardedBuffers_.Push(graphics_.get(), std::move(gpuBuf), cpuBuf == nullptr);
+	gpuBuf = std::move(buffer);
+
+	// a new buffer is written directly, so a staging buffer is not needed anymore
+	cpuBuf.reset();
+
+	return Lock();
+}
+
 void IndexBufferVulkan::Unlock()
 {
+	// memory in a pool is coherent and kept mapped
+	if (mappedData_ != nullptr)
+	{
+		return;
+	}
+
+	if (cpuBuf == nullptr)
+	{
+		graphics_->GetDevice().unmapMemory(gpuBuf->devMem());
+		return;
+	}
 
 	graphics_->GetDevice().unmapMemory(cpuBuf->devMem());
 
@@ -91,12 +219,7 @@ void IndexBufferVulkan::Unlock()
 	copyCommandBuffer.end();
 
 	// submit and wait to execute command
-	std::array<vk::SubmitInfo, 1> copySubmitInfos;
-	copySubmitInfos[0].commandBufferCount = 1;
-	copySubmitInfos[0].pCommandBuffers = &copyCommandBuffer;
-
-	graphics_->GetQueue().submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), vk::Fence());
-	graphics_->GetQueue().waitIdle();
+	graphics_->SubmitAndWait(copyCommandBuffer);
 
 	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
 }
@@ -399,6 +399,38 @@ bool PipelineStateVulkan::Compile()
 
 	graphicsPipelineInfo.renderPass = renderPass;
 
+#if defined(VK_VERSION_1_3)
+	// only formats are specified with dynamic rendering
+	FixedSizeVector<VkFormat, RenderTargetMax> colorFormats;
+	VkPipelineRenderingCreateInfo renderingCreateInfo = {};
+
+	if (renderPassPipelineState->IsDynamicRendering)
+	{
+		const auto& key = renderPassPipelineState->Key;
+		colorFormats.resize(key.RenderTargetFormats.size());
+		for (size_t i = 0; i < key.RenderTargetFormats.size(); i++)
+		{
+			colorFormats.at(i) = VulkanHelper::TextureFormatToVkFormat(key.RenderTargetFormats.at(i));
+		}
+
+		renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+		renderingCreateInfo.colorAttachmentCount = static_cast<uint32_t>(colorFormats.size());
+		renderingCreateInfo.pColorAttachmentFormats = colorFormats.size() > 0 ? colorFormats.data() : nullptr;
+
+		if (key.DepthFormat != TextureFormatType::Unknown)
+		{
+			renderingCreateInfo.depthAttachmentFormat = VulkanHelper::TextureFormatToVkFormat(key.DepthFormat);
+			if (HasStencil(key.DepthFormat))
+			{
+				renderingCreateInfo.stencilAttachmentFormat = renderingCreateInfo.depthAttachmentFormat;
+			}
+		}
+
+		graphicsPipelineInfo.pNext = &renderingCreateInfo;
+		graphicsPipelineInfo.renderPass = nullptr;
+	}
+#endif
+
 	// uniform layout info
 	std::array<vk::DescriptorSetLayoutBinding, TextureSlotMax + 1> uboLayoutBindings;
 	uboLayoutBindings[0].binding = 0;
@@ -137,7 +137,6 @@ bool PlatformVulkan::CreateSwapChain(Vec2I windowSize, bool waitVSync)
 		swapBuffers[i].image = swapChainImages[i];
 		viewCreateInfo.image = swapChainImages[i];
 		swapBuffers[i].view = vkDevice_.createImageView(viewCreateInfo);
-		swapBuffers[i].fence = vk::Fence();
 
 		swapBuffers[i].texture = new TextureVulkan();
 		if (!swapBuffers[i].texture->InitializeAsScreen(swapBuffers[i].image, swapBuffers[i].view, surfaceFormat, windowSize))
@@ -185,6 +184,8 @@ void PlatformVulkan::CreateRenderPass()
 
 uint32_t PlatformVulkan::AcquireNextImage(vk::Semaphore& semaphore)
 {
+	// an acquisition may block until queued presents are processed, so they are drained instead of locking the swapchain
+	commandQueue_->WaitPresents();
 	auto resultValue = vkDevice_.acquireNextImageKHR(swapchain_, UINT64_MAX, semaphore, vk::Fence());
 	assert(resultValue.result == vk::Result::eSuccess);
 
@@ -192,43 +193,10 @@ uint32_t PlatformVulkan::AcquireNextImage(vk::Semaphore& semaphore)
 	return frameIndex;
 }
 
-vk::Fence PlatformVulkan::GetSubmitFence(bool destroy)
-{
-	auto& image = swapBuffers[frameIndex];
-	while (image.fence)
-	{
-		vk::Result fenceRes = vkDevice_.waitForFences(image.fence, VK_TRUE, std::numeric_limits<int>::max());
-		if (fenceRes == vk::Result::eSuccess)
-		{
-			if (destroy)
-			{
-				vkDevice_.destroyFence(image.fence);
-			}
-			image.fence = vk::Fence();
-		}
-	}
-
-	image.fence = vkDevice_.createFence(vk::FenceCreateFlags());
-	return image.fence;
-}
-
 vk::Result PlatformVulkan::Present(vk::Semaphore semaphore)
 {
-	vk::PresentInfoKHR presentInfo;
-	presentInfo.swapchainCount = 1;
-	presentInfo.pSwapchains = &swapchain_;
-	presentInfo.pImageIndices = &frameIndex;
-	presentInfo.waitSemaphoreCount = semaphore ? 1 : 0;
-	presentInfo.pWaitSemaphores = &semaphore;
-
-	try
-	{
-		return vkQueue.presentKHR(presentInfo);
-	}
-	catch (const vk::OutOfDateKHRError&)
-	{
-		return vk::Result::eErrorOutOfDateKHR;
-	}
+	// the command queue presents in the submission thread if it is enabled
+	return commandQueue_->Present(swapchain_, frameIndex, semaphore);
 }
 
 void PlatformVulkan::Reset()
@@ -242,11 +210,6 @@ void PlatformVulkan::Reset()
 				vkDevice_.destroyImageView(swapBuffer.view);
 			}
 
-			if (swapBuffer.fence)
-			{
-				vkDevice_.destroyFence(swapBuffer.fence);
-			}
-
 			SafeRelease(swapBuffer.texture);
 		}
 		swapBuffers.clear();
@@ -265,17 +228,24 @@ void PlatformVulkan::Reset()
 			vkPipelineCache_ = nullptr;
 		}
 
-		if (vkPresentComplete_)
+		for (auto& frameSlot : frameSlots_)
 		{
-			vkDevice_.destroySemaphore(vkPresentComplete_);
-			vkPresentComplete_ = nullptr;
-		}
+			if (frameSlot.presentComplete)
+			{
+				vkDevice_.destroySemaphore(frameSlot.presentComplete);
+			}
 
-		if (vkRenderComplete_)
-		{
-			vkDevice_.destroySemaphore(vkRenderComplete_);
-			vkRenderComplete_ = nullptr;
+			if (frameSlot.renderComplete)
+			{
+				vkDevice_.destroySemaphore(frameSlot.renderComplete);
+			}
+
+			if (frameSlot.commandPool)
+			{
+				vkDevice_.destroyCommandPool(frameSlot.commandPool);
+			}
 		}
+		frameSlots_.clear();
 
 		if (vkCmdPool_)
 		{
@@ -344,6 +314,11 @@ PlatformVulkan::~PlatformVulkan()
 	// destroy vulkan
 
 	// wait
+	if (commandQueue_ != nullptr)
+	{
+		commandQueue_->WaitIdle();
+	}
+
 	if (vkQueue)
 	{
 		vkQueue.waitIdle();
@@ -371,6 +346,8 @@ PlatformVulkan::~PlatformVulkan()
 
 	SafeRelease(renderPassPipelineStateCache_);
 
+	SafeRelease(commandQueue_);
+
 	if (vkDevice_)
 	{
 		vkDevice_.destroy();
@@ -390,10 +367,12 @@ PlatformVulkan::~PlatformVulkan()
 	}
 }
 
-bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
+bool PlatformVulkan::Initialize(Window* window, bool waitVSync, int32_t frameCount, bool useSubmissionThread, bool useDynamicRendering)
 {
 	window_ = window;
 	waitVSync_ = waitVSync;
+	frameCount_ = std::max(1, frameCount);
+	maxFrameLatency_ = frameCount_;
 
 	// initialize Vulkan context
 
@@ -404,6 +383,37 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 	appInfo.engineVersion = 1;
 	appInfo.apiVersion = VK_API_VERSION_1_0;
 
+#if defined(VK_VERSION_1_2)
+	// a timeline semaphore requires Vulkan 1.1, a depth resolve is a feature of Vulkan 1.2
+	// and dynamic rendering is a feature of Vulkan 1.3, and an old loader fails to create an instance with them
+	{
+		auto enumerateInstanceVersion =
+			reinterpret_cast<PFN_vkEnumerateInstanceVersion>(vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+		uint32_t instanceVersion = VK_API_VERSION_1_0;
+		if (enumerateInstanceVersion == nullptr || enumerateInstanceVersion(&instanceVersion) != VK_SUCCESS)
+		{
+			instanceVersion = VK_API_VERSION_1_0;
+		}
+
+		if (instanceVersion >= VK_API_VERSION_1_1)
+		{
+			appInfo.apiVersion = VK_API_VERSION_1_1;
+		}
+
+		if (instanceVersion >= VK_API_VERSION_1_2)
+		{
+			appInfo.apiVersion = VK_API_VERSION_1_2;
+		}
+
+#if defined(VK_VERSION_1_3)
+		if (useDynamicRendering && instanceVersion >= VK_API_VERSION_1_3)
+		{
+			appInfo.apiVersion = VK_API_VERSION_1_3;
+		}
+#endif
+	}
+#endif
+
 	// specify extension
 	const std::vector<const char*> extensions = {
 		VK_KHR_SURFACE_EXTENSION_NAME,
@@ -526,12 +536,36 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		queueCreateInfo.pQueuePriorities = queuePriorities;
 		queueFamilyIndex_ = queueCreateInfo.queueFamilyIndex;
 
-		const std::vector<const char*> enabledExtensions = {
+		std::vector<const char*> enabledExtensions = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 #if !defined(NDEBUG)
 		// VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
 #endif
 		};
+
+		// a timeline semaphore is used to track submissions if it is supported
+		// the extension depends on Vulkan 1.1 or VK_KHR_get_physical_device_properties2 which is not enabled in the instance,
+		// so it is used only with an instance of Vulkan 1.1 or later
+		bool isTimelineSemaphoreEnabled = false;
+#if defined(VK_KHR_timeline_semaphore)
+		VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures = {};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+		if (appInfo.apiVersion >= VK_API_VERSION_1_1)
+		{
+			for (const auto& extension : vkPhysicalDevice.enumerateDeviceExtensionProperties())
+			{
+				if (strcmp(extension.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0)
+				{
+					enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+					isTimelineSemaphoreEnabled = true;
+					break;
+				}
+			}
+		}
+#endif
+
 		vk::DeviceCreateInfo deviceCreateInfo;
 		deviceCreateInfo.queueCreateInfoCount = 1;
 		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
@@ -539,6 +573,52 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
 		deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
+#if defined(VK_KHR_timeline_semaphore)
+		if (isTimelineSemaphoreEnabled)
+		{
+			deviceCreateInfo.pNext = &timelineSemaphoreFeatures;
+		}
+#endif
+
+		isDynamicRenderingEnabled_ = false;
+#if defined(VK_VERSION_1_3)
+		VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+		dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+
+		if (useDynamicRendering && appInfo.apiVersion >= VK_API_VERSION_1_3 && deviceProperties.apiVersion >= VK_API_VERSION_1_3)
+		{
+			auto getPhysicalDeviceFeatures2 =
+				reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(vkInstance_.getProcAddr("vkGetPhysicalDeviceFeatures2"));
+
+			if (getPhysicalDeviceFeatures2 != nullptr)
+			{
+				VkPhysicalDeviceFeatures2 features2 = {};
+				features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				features2.pNext = &dynamicRenderingFeatures;
+				getPhysicalDeviceFeatures2(static_cast<VkPhysicalDevice>(vkPhysicalDevice), &features2);
+			}
+
+			if (dynamicRenderingFeatures.dynamicRendering == VK_TRUE)
+			{
+				// chained in front of other features
+				dynamicRenderingFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+				deviceCreateInfo.pNext = &dynamicRenderingFeatures;
+				isDynamicRenderingEnabled_ = true;
+			}
+		}
+#endif
+
+		if (useDynamicRendering && !isDynamicRenderingEnabled_)
+		{
+			Log(LogType::Warning, "Dynamic rendering is not supported. Render pass objects are used.");
+		}
+
+		// a resolve mode which takes a sample zero is supported by all devices with Vulkan 1.2
+		isDepthResolveEnabled_ = false;
+#if defined(VK_VERSION_1_2)
+		isDepthResolveEnabled_ = appInfo.apiVersion >= VK_API_VERSION_1_2 && deviceProperties.apiVersion >= VK_API_VERSION_1_2;
+#endif
+
 #if !defined(NDEBUG)
 		if (optimalLayers.size() > 0)
 		{
@@ -577,6 +657,7 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		vkPipelineCache_ = vkDevice_.createPipelineCache(vk::PipelineCacheCreateInfo());
 
 		vkQueue = vkDevice_.getQueue(graphicsQueueInd, 0);
+		commandQueue_ = new CommandQueueVulkan(vkDevice_, vkQueue, isTimelineSemaphoreEnabled, useSubmissionThread);
 
 		// create command pool
 		vk::CommandPoolCreateInfo cmdPoolInfo;
@@ -607,18 +688,29 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 			return false;
 		}
 
-		// create semaphore
+		// create semaphores and command buffers for each frame in flight
+		// they are not related to the number of swap buffers which a driver returns
 		vk::SemaphoreCreateInfo semaphoreCreateInfo;
 
-		vkPresentComplete_ = vkDevice_.createSemaphore(semaphoreCreateInfo);
+		// a transient pool is reset at once when the frame slot is reused
+		vk::CommandPoolCreateInfo framePoolInfo;
+		framePoolInfo.queueFamilyIndex = graphicsQueueInd;
+		framePoolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
 
-		vkRenderComplete_ = vkDevice_.createSemaphore(semaphoreCreateInfo);
+		frameSlots_.resize(frameCount_);
+		for (int32_t i = 0; i < frameCount_; i++)
+		{
+			frameSlots_[i].presentComplete = vkDevice_.createSemaphore(semaphoreCreateInfo);
+			frameSlots_[i].renderComplete = vkDevice_.createSemaphore(semaphoreCreateInfo);
+			frameSlots_[i].commandPool = vkDevice_.createCommandPool(framePoolInfo);
+
+			vk::CommandBufferAllocateInfo allocInfo;
+			allocInfo.commandPool = frameSlots_[i].commandPool;
+			allocInfo.commandBufferCount = 1;
+			frameSlots_[i].commandBuffer = vkDevice_.allocateCommandBuffers(allocInfo)[0];
+		}
 
-		// create command buffer
-		vk::CommandBufferAllocateInfo allocInfo;
-		allocInfo.commandPool = vkCmdPool_;
-		allocInfo.commandBufferCount = swapBufferCount;
-		vkCmdBuffers = vkDevice_.allocateCommandBuffers(allocInfo);
+		SetMaxFrameLatency(maxFrameLatency_);
 
 		// create depth buffer
 		if (!CreateDepthBuffer(window->GetWindowSize()))
@@ -628,7 +720,8 @@ bool PlatformVulkan::Initialize(Window* window, bool waitVSync)
 		}
 
 		windowSize_ = window->GetWindowSize();
-		renderPassPipelineStateCache_ = new RenderPassPipelineStateCacheVulkan(vkDevice_, nullptr);
+		renderPassPipelineStateCache_ =
+			new RenderPassPipelineStateCacheVulkan(vkDevice_, nullptr, isDynamicRenderingEnabled_, isDepthResolveEnabled_, commandQueue_);
 
 		// create renderpasses
 		CreateRenderPass();
@@ -653,23 +746,40 @@ bool PlatformVulkan::NewFrame()
 		return false;
 	}
 
-	AcquireNextImage(vkPresentComplete_);
-	executedCommandCount = 0;
+	// wait only when gpu is still using resources of a frame which is reused
+	currentFrameSlot_ = static_cast<int32_t>(presentedFrameCount_ % static_cast<uint64_t>(maxFrameLatency_));
+	auto& frameSlot = frameSlots_[currentFrameSlot_];
+	if (!commandQueue_->Wait(frameSlot.submittedValue))
+	{
+		return false;
+	}
+
+	AcquireNextImage(frameSlot.presentComplete);
+
+	// commands in this frame may write the swap buffer, so the first submission waits for it to be acquired
+	// even if commands are flushed before Present
+	commandQueue_->AddWaitSemaphore(frameSlot.presentComplete, vk::PipelineStageFlagBits::eAllCommands);
+
+	enqueuedCountOnNewFrame_ = commandQueue_->GetEnqueuedCount();
 	return true;
 }
 
 void PlatformVulkan::Present()
 {
 
+	auto& frameSlot = frameSlots_[currentFrameSlot_];
+
 	// waiting or empty command
-	auto& cmdBuffer = vkCmdBuffers[frameIndex];
+	auto& cmdBuffer = frameSlot.commandBuffer;
 
-	cmdBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
+	// gpu finished a previous frame in this slot in NewFrame, memory is kept for this frame
+	vkDevice_.resetCommandPool(frameSlot.commandPool, vk::CommandPoolResetFlags());
 	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 	cmdBuffer.begin(cmdBufInfo);
 
 	// typical driver causes errors without present command
-	if (executedCommandCount == 0)
+	if (commandQueue_->GetEnqueuedCount() == enqueuedCountOnNewFrame_)
 	{
 		vk::ClearColorValue clearColor(std::array<float, 4>{0, 0, 0, 0});
 		// vk::ClearDepthStencilValue clearDepth(1.0f, 0);
@@ -706,42 +816,35 @@ void PlatformVulkan::Present()
 
 	cmdBuffer.end();
 
-	{
-		vk::PipelineStageFlags pipelineStages = vk::PipelineStageFlagBits::eBottomOfPipe;
-		vk::SubmitInfo submitInfo;
-		submitInfo.pWaitDstStageMask = &pipelineStages;
+	// submit all commands in this frame at once
+	commandQueue_->Enqueue(cmdBuffer);
+	commandQueue_->AddSignalSemaphore(frameSlot.renderComplete);
 
-		// send semaphore to be need to wait
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = &vkPresentComplete_;
+	// cpu does not wait here and starts a next frame while gpu renders this frame
+	frameSlot.submittedValue = commandQueue_->Flush();
 
-		// set command
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &cmdBuffer;
+	presentedFrameCount_++;
 
-		// set a semaphore which notify to finish to execute commands
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = &vkRenderComplete_;
+	auto result = Present(frameSlot.renderComplete);
 
-		vk::Fence fence = GetSubmitFence(true);
-		vkQueue.submit(submitInfo, fence);
-		vk::Result fenceRes = vkDevice_.waitForFences(fence, VK_TRUE, std::numeric_limits<int>::max());
-		if (fenceRes != vk::Result::eSuccess)
-		{
-			throw "Invalid waitForFences";
-		}
+	if (commandQueue_->PopSubmitResult() != vk::Result::eSuccess)
+	{
+		Log(LogType::Error, "PlatformVulkan : Commands of a frame were not executed.");
 	}
 
-	auto result = Present(vkRenderComplete_);
-
 	// TODO optimize it
 	if (result == vk::Result::eErrorOutOfDateKHR)
 	{
+		commandQueue_->WaitIdle();
 		vkDevice_.waitIdle();
 		CreateSwapChain(windowSize_, waitVSync_);
 		CreateDepthBuffer(windowSize_);
 		CreateRenderPass();
 	}
+	else if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
+	{
+		Log(LogType::Error, "PlatformVulkan : Failed to present.");
+	}
 }
 
 void PlatformVulkan::SetWindowSize(const Vec2I& windowSize)
@@ -751,6 +854,7 @@ void PlatformVulkan::SetWindowSize(const Vec2I& windowSize)
 		return;
 	}
 
+	commandQueue_->WaitIdle();
 	vkDevice_.waitIdle();
 	CreateSwapChain(windowSize, waitVSync_);
 
@@ -760,6 +864,11 @@ void PlatformVulkan::SetWindowSize(const Vec2I& windowSize)
 	windowSize_ = windowSize;
 }
 
+void PlatformVulkan::SetMaxFrameLatency(int32_t maxFrameLatency)
+{
+	maxFrameLatency_ = std::max(1, std::min(maxFrameLatency, static_cast<int32_t>(frameSlots_.size())));
+}
+
 Graphics* PlatformVulkan::CreateGraphics()
 {
 	auto addCommand = [this](vk::CommandBuffer commandBuffer, vk::Fence fence) -> void {
@@ -767,18 +876,21 @@ Graphics* PlatformVulkan::CreateGraphics()
 		copySubmitInfos[0].commandBufferCount = 1;
 		copySubmitInfos[0].pCommandBuffers = &commandBuffer;
 		vkQueue.submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), fence);
-
-		this->executedCommandCount++;
 	};
 
+	auto getPresentedFrameCount = [this]() -> uint64_t { return this->presentedFrameCount_; };
+
 	auto graphics = new GraphicsVulkan(vkDevice_,
 									   vkQueue,
 									   vkCmdPool_,
 									   vkPhysicalDevice,
-									   static_cast<int32_t>(swapBuffers.size()),
+									   frameCount_,
 									   addCommand,
 									   renderPassPipelineStateCache_,
-									   this);
+									   this,
+									   getPresentedFrameCount,
+									   commandQueue_,
+									   queueFamilyIndex_);
 
 	return graphics;
 }
@@ -4,6 +4,7 @@
 
 #include "../LLGI.Platform.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
 
 #ifdef _WIN32
 #include "../Win/LLGI.WindowWin.h"
@@ -33,7 +34,6 @@ private:
 	public:
 		vk::Image image = nullptr;
 		vk::ImageView view = nullptr;
-		vk::Fence fence = nullptr;
 		TextureVulkan* texture = nullptr;
 	};
 
@@ -52,17 +52,40 @@ private:
 	vk::Device vkDevice_ = nullptr;
 	vk::PipelineCache vkPipelineCache_ = nullptr;
 	vk::Queue vkQueue = nullptr;
+	CommandQueueVulkan* commandQueue_ = nullptr;
 	vk::CommandPool vkCmdPool_ = nullptr;
 	int32_t queueFamilyIndex_ = 0;
 
+	//! whether a device is created with a dynamic rendering feature
+	bool isDynamicRenderingEnabled_ = false;
+
+	//! whether depth can be resolved in a render pass, which requires Vulkan 1.2
+	bool isDepthResolveEnabled_ = false;
+
 	Vec2I windowSize_;
 
-	//! to check to finish present
-	vk::Semaphore vkPresentComplete_;
+	//! resources for a frame which is being rendered by gpu
+	struct FrameSlot
+	{
+		//! to check to finish present
+		vk::Semaphore presentComplete = nullptr;
+
+		//! to check to finish render
+		vk::Semaphore renderComplete = nullptr;
+
+		//! a transient pool which commandBuffer is allocated from
+		vk::CommandPool commandPool = nullptr;
 
-	//! to check to finish render
-	vk::Semaphore vkRenderComplete_;
-	std::vector<vk::CommandBuffer> vkCmdBuffers;
+		vk::CommandBuffer commandBuffer = nullptr;
+
+		//! a value of the command queue which is completed when gpu finishes the frame
+		uint64_t submittedValue = 0;
+	};
+
+	std::vector<FrameSlot> frameSlots_;
+	int32_t currentFrameSlot_ = 0;
+	int32_t frameCount_ = 2;
+	int32_t maxFrameLatency_ = 2;
 
 	vk::SurfaceKHR surface_ = nullptr;
 	vk::SwapchainKHR swapchain_ = nullptr;
@@ -80,7 +103,11 @@ private:
 
 	std::vector<SwapBuffer> swapBuffers;
 
-	int32_t executedCommandCount = 0;
+	//! the number of command buffers which were enqueued before this frame
+	uint64_t enqueuedCountOnNewFrame_ = 0;
+
+	//! the number of frames whose commands were submitted in Present
+	uint64_t presentedFrameCount_ = 0;
 
 	Window* window_ = nullptr;
 
@@ -104,8 +131,6 @@ private:
 	*/
 	uint32_t AcquireNextImage(vk::Semaphore& semaphore);
 
-	vk::Fence GetSubmitFence(bool destroy = false);
-
 	/**
 		@brief	the semaphore to wait for before present
 	*/
@@ -127,7 +152,16 @@ public:
 	PlatformVulkan();
 	~PlatformVulkan() override;
 
-	bool Initialize(Window* window, bool waitVSync);
+	/**
+		@brief	initialize
+		@param	frameCount	the number of frames in flight, which is independent of the number of swap buffers
+		@param	useSubmissionThread	submit commands and present in a dedicated thread
+		@param	useDynamicRendering	begin render passes with vkCmdBeginRendering if Vulkan 1.3 is supported
+	*/
+	bool Initialize(
+		Window* window, bool waitVSync, int32_t frameCount = 2, bool useSubmissionThread = false, bool useDynamicRendering = false);
+
+	bool GetIsDynamicRenderingEnabled() const { return isDynamicRenderingEnabled_; }
 
 	bool NewFrame() override;
 	void Present() override;
@@ -147,6 +181,8 @@ public:
 
 	vk::Queue GetQueue() const { return vkQueue; }
 
+	CommandQueueVulkan* GetCommandQueue() const { return commandQueue_; }
+
 	int32_t GetSwapBufferCountMin() const { return swapBufferCountMin_; }
 
 	int32_t GetSwapBufferCount() const { return swapBufferCount; }
@@ -155,7 +191,16 @@ public:
 
 	DeviceType GetDeviceType() const override { return DeviceType::Vulkan; }
 
-	int GetMaxFrameCount() const override { return static_cast<int>(swapBufferCount); }
+	int GetMaxFrameCount() const override { return static_cast<int>(frameCount_); }
+
+	/**
+		@brief	set the number of frames which cpu can prepare before gpu finishes them
+		@note
+		It is clamped between 1 and the number of frames in flight.
+	*/
+	void SetMaxFrameLatency(int32_t maxFrameLatency);
+
+	int32_t GetMaxFrameLatency() const { return maxFrameLatency_; }
 };
 
 } // namespace LLGI
@@ -0,0 +1,195 @@
+#include "LLGI.ReadbackVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+#include <algorithm>
+
+namespace LLGI
+{
+
+ReadbackBufferPoolVulkan::ReadbackBufferPoolVulkan(GraphicsVulkan* graphics) : graphics_(graphics), device_(graphics->GetDevice()) {}
+
+ReadbackBufferPoolVulkan::~ReadbackBufferPoolVulkan()
+{
+	// GraphicsVulkan waits for gpu before it is disposed
+	for (auto& entry : freeEntries_)
+	{
+		Dispose(entry);
+	}
+	freeEntries_.clear();
+
+	for (auto& entry : pendingEntries_)
+	{
+		Dispose(entry.second);
+	}
+	pendingEntries_.clear();
+}
+
+void ReadbackBufferPoolVulkan::Dispose(Entry& entry)
+{
+	if (entry.memory)
+	{
+		device_.unmapMemory(entry.memory);
+		device_.freeMemory(entry.memory);
+	}
+
+	if (entry.buffer)
+	{
+		device_.destroyBuffer(entry.buffer);
+	}
+
+	entry = Entry();
+}
+
+bool ReadbackBufferPoolVulkan::Acquire(vk::DeviceSize size, Entry& entry)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto commandQueue = graphics_->GetCommandQueue();
+		for (size_t i = 0; i < pendingEntries_.size();)
+		{
+			if (commandQueue->IsCompleted(pendingEntries_[i].first))
+			{
+				freeEntries_.push_back(pendingEntries_[i].second);
+				pendingEntries_.erase(pendingEntries_.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		// find the smallest buffer which is not too large
+		int32_t found = -1;
+		for (size_t i = 0; i < freeEntries_.size(); i++)
+		{
+			const auto& e = freeEntries_[i];
+			if (e.size < size || e.size > size * 2)
+			{
+				continue;
+			}
+
+			if (found < 0 || e.size < freeEntries_[found].size)
+			{
+				found = static_cast<int32_t>(i);
+			}
+		}
+
+		if (found >= 0)
+		{
+			entry = freeEntries_[found];
+			freeEntries_.erase(freeEntries_.begin() + found);
+			return true;
+		}
+	}
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.size = size;
+	bufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst;
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+	entry.buffer = device_.createBuffer(bufferInfo);
+	entry.size = size;
+
+	auto memReqs = device_.getBufferMemoryRequirements(entry.buffer);
+
+	// cached memory is faster to read from cpu
+	uint32_t memoryTypeIndex = 0;
+	if (!graphics_->TryGetMemoryTypeIndex(memReqs.memoryTypeBits,
+										  vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent |
+											  vk::MemoryPropertyFlagBits::eHostCached,
+										  memoryTypeIndex) &&
+		!graphics_->TryGetMemoryTypeIndex(memReqs.memoryTypeBits,
+										  vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+										  memoryTypeIndex))
+	{
+		Log(LogType::Error, "Readback : Failed to find a memory type.");
+		Dispose(entry);
+		return false;
+	}
+
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex = memoryTypeIndex;
+	entry.memory = device_.allocateMemory(memAlloc);
+	device_.bindBufferMemory(entry.buffer, entry.memory, 0);
+
+	entry.mapped = static_cast<uint8_t*>(device_.mapMemory(entry.memory, 0, size));
+	return true;
+}
+
+void ReadbackBufferPoolVulkan::Release(Entry& entry, uint64_t value)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (value != 0 && !graphics_->GetCommandQueue()->IsCompleted(value))
+	{
+		pendingEntries_.push_back(std::make_pair(value, entry));
+		entry = Entry();
+		return;
+	}
+
+	if (freeEntries_.size() < MaxFreeEntryCount)
+	{
+		freeEntries_.push_back(entry);
+		entry = Entry();
+		return;
+	}
+
+	Dispose(entry);
+}
+
+ReadbackTicketVulkan::ReadbackTicketVulkan(std::shared_ptr<GraphicsVulkan> graphics,
+										   std::shared_ptr<ReadbackBufferPoolVulkan> pool,
+										   const ReadbackBufferPoolVulkan::Entry& entry,
+										   const Vec2I& size,
+										   int32_t rowPitch,
+										   TextureFormatType format)
+	: graphics_(graphics), pool_(pool), entry_(entry), size_(size), rowPitch_(rowPitch), format_(format)
+{
+}
+
+ReadbackTicketVulkan::~ReadbackTicketVulkan()
+{
+	// a buffer is not reused while gpu writes it
+	pool_->Release(entry_, submittedValue_.load());
+}
+
+bool ReadbackTicketVulkan::IsCompleted()
+{
+	auto value = submittedValue_.load();
+	return value != 0 && graphics_->GetCommandQueue()->IsCompleted(value);
+}
+
+bool ReadbackTicketVulkan::Wait()
+{
+	auto value = submittedValue_.load();
+	if (value == 0)
+	{
+		return false;
+	}
+
+	return graphics_->GetCommandQueue()->Wait(value);
+}
+
+bool ReadbackTicketVulkan::Wait(int32_t timeoutMilliseconds)
+{
+	auto value = submittedValue_.load();
+	if (value == 0)
+	{
+		return false;
+	}
+
+	const auto timeout = static_cast<uint64_t>(std::max(timeoutMilliseconds, 0)) * 1000 * 1000;
+	return graphics_->GetCommandQueue()->WaitFor(value, timeout);
+}
+
+const void* ReadbackTicketVulkan::GetData()
+{
+	if (!IsCompleted())
+	{
+		return nullptr;
+	}
+
+	return entry_.mapped;
+}
+
+} // namespace LLGI
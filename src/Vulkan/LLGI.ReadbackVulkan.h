@@ -0,0 +1,101 @@
+
+#pragma once
+
+#include "../LLGI.CommandList.h"
+#include "LLGI.BaseVulkan.h"
+#include <atomic>
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	a pool of buffers which gpu copies textures into and cpu reads from
+	@note
+	Buffers are mapped persistently and reused after tickets are released and gpu finishes writing them.
+	Buffers can be returned from any thread.
+*/
+class ReadbackBufferPoolVulkan
+{
+public:
+	struct Entry
+	{
+		vk::Buffer buffer;
+		vk::DeviceMemory memory;
+		uint8_t* mapped = nullptr;
+		vk::DeviceSize size = 0;
+	};
+
+private:
+	GraphicsVulkan* graphics_ = nullptr;
+	vk::Device device_;
+	std::mutex mutex_;
+	std::vector<Entry> freeEntries_;
+
+	//! buffers which were released while gpu may write them, with values of a command queue
+	std::vector<std::pair<uint64_t, Entry>> pendingEntries_;
+
+	//! the number of unused buffers which are kept
+	static const size_t MaxFreeEntryCount = 16;
+
+	void Dispose(Entry& entry);
+
+public:
+	ReadbackBufferPoolVulkan(GraphicsVulkan* graphics);
+	~ReadbackBufferPoolVulkan();
+
+	bool Acquire(vk::DeviceSize size, Entry& entry);
+
+	/**
+		@brief	return a buffer
+		@param	value	a value of a command queue which is completed when gpu finishes writing, 0 if it was not submitted
+	*/
+	void Release(Entry& entry, uint64_t value);
+};
+
+class ReadbackTicketVulkan : public ReadbackTicket
+{
+private:
+	std::shared_ptr<GraphicsVulkan> graphics_;
+	std::shared_ptr<ReadbackBufferPoolVulkan> pool_;
+	ReadbackBufferPoolVulkan::Entry entry_;
+
+	//! it is set when a command list is executed and read in any thread
+	std::atomic<uint64_t> submittedValue_{0};
+
+	Vec2I size_;
+	int32_t rowPitch_ = 0;
+	TextureFormatType format_ = TextureFormatType::Unknown;
+
+public:
+	ReadbackTicketVulkan(std::shared_ptr<GraphicsVulkan> graphics,
+						 std::shared_ptr<ReadbackBufferPoolVulkan> pool,
+						 const ReadbackBufferPoolVulkan::Entry& entry,
+						 const Vec2I& size,
+						 int32_t rowPitch,
+						 TextureFormatType format);
+
+	~ReadbackTicketVulkan() override;
+
+	void SetSubmittedValue(uint64_t value) { submittedValue_ = value; }
+
+	//! it can be called in any thread
+	bool IsCompleted() override;
+
+	//! it must be called in a thread which executes command lists
+	bool Wait() override;
+
+	bool Wait(int32_t timeoutMilliseconds) override;
+
+	const void* GetData() override;
+
+	int32_t GetRowPitch() const override { return rowPitch_; }
+
+	Vec2I GetSize() const override { return size_; }
+
+	TextureFormatType GetFormat() const override { return format_; }
+
+	vk::Buffer GetBuffer() const { return entry_.buffer; }
+};
+
+} // namespace LLGI
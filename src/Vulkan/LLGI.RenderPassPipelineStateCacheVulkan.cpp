@@ -3,42 +3,53 @@
 namespace LLGI
 {
 
-RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner)
+RenderPassPipelineStateCacheVulkan::RenderPassPipelineStateCacheVulkan(vk::Device device,
+																	   ReferenceObject* owner,
+																	   bool isDynamicRenderingEnabled,
+																	   bool isDepthResolveEnabled,
+																	   CommandQueueVulkan* commandQueue)
 	: device_(device), owner_(owner)
 {
 	SafeAddRef(owner_);
+	framebufferCache_ = std::make_shared<FramebufferCacheVulkan>(device_, commandQueue);
+
+#if defined(VK_VERSION_1_3)
+	if (isDynamicRenderingEnabled)
+	{
+		cmdBeginRendering_ = reinterpret_cast<PFN_vkCmdBeginRendering>(device_.getProcAddr("vkCmdBeginRendering"));
+		cmdEndRendering_ = reinterpret_cast<PFN_vkCmdEndRendering>(device_.getProcAddr("vkCmdEndRendering"));
+		isDynamicRenderingEnabled_ = cmdBeginRendering_ != nullptr && cmdEndRendering_ != nullptr;
+	}
+#endif
+
+#if defined(VK_VERSION_1_2)
+	if (isDepthResolveEnabled)
+	{
+		// dynamic rendering resolves depth without render pass objects
+		createRenderPass2_ = reinterpret_cast<PFN_vkCreateRenderPass2>(device_.getProcAddr("vkCreateRenderPass2"));
+		isDepthResolveEnabled_ = createRenderPass2_ != nullptr || isDynamicRenderingEnabled_;
+	}
+#endif
 }
 
 RenderPassPipelineStateCacheVulkan::~RenderPassPipelineStateCacheVulkan()
 {
+	// textures which outlive this cache do not touch framebuffers
+	framebufferCache_->Clear();
+	framebufferCache_.reset();
+
 	renderPassPipelineStates_.clear();
 	SafeRelease(owner_);
 }
 
-RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const RenderPassPipelineStateKey key)
+vk::RenderPass RenderPassPipelineStateCacheVulkan::CreateRenderPass(const RenderPassPipelineStateKey& key,
+																	 const RenderPassActionsVulkan& actions,
+																	 FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1>& finalLayouts)
 {
-	// already?
-	{
-		auto it = renderPassPipelineStates_.find(key);
-
-		if (it != renderPassPipelineStates_.end())
-		{
-			auto ret = it->second;
-
-			if (ret != nullptr)
-			{
-				auto retptr = ret.get();
-				SafeAddRef(retptr);
-				return retptr;
-			}
-		}
-	}
-
 	// settings
 	bool hasDepth = key.DepthFormat != TextureFormatType::Unknown;
 	FixedSizeVector<vk::AttachmentDescription, RenderTargetMax + 1> attachmentDescs;
 	FixedSizeVector<vk::AttachmentReference, RenderTargetMax + 1> attachmentRefs;
-	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts;
 
 	int colorCount = static_cast<int32_t>(key.RenderTargetFormats.size());
 	int depthCount = key.DepthFormat != TextureFormatType::Unknown ? 1 : 0;
@@ -52,59 +63,52 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 	{
 		attachmentDescs.at(i).format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.RenderTargetFormats.at(i));
 		attachmentDescs.at(i).samples = (vk::SampleCountFlagBits)key.SamplingCount;
-
-		if (key.IsColorCleared)
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eClear;
-		else
-			attachmentDescs.at(i).loadOp = vk::AttachmentLoadOp::eDontCare;
-
-		attachmentDescs.at(i).storeOp = vk::AttachmentStoreOp::eStore;
+		attachmentDescs.at(i).loadOp = RenderPassActionsVulkan::GetLoadOp(actions.ColorLoadActions[i]);
+		const auto isResolved = i == 0 && key.HasResolvedRenderTarget;
+		attachmentDescs.at(i).storeOp = RenderPassActionsVulkan::GetStoreOp(actions.ColorStoreActions[i], isResolved);
 		attachmentDescs.at(i).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
 		attachmentDescs.at(i).stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
 	}
 
 	if (key.IsPresent)
 	{
-		// When clearing, the initialLayout does not matter.
-		attachmentDescs.at(0).initialLayout = (key.IsColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
+		// When not loading, the initialLayout does not matter.
+		attachmentDescs.at(0).initialLayout =
+			(actions.ColorLoadActions[0] != LoadAction::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::ePresentSrcKHR;
 		attachmentDescs.at(0).finalLayout = vk::ImageLayout::ePresentSrcKHR;
 	}
 	else
 	{
 		for (int i = 0; i < colorCount; i++)
 		{
-			// When clearing, the initialLayout does not matter.
+			// When not loading, the initialLayout does not matter.
 			attachmentDescs.at(i).initialLayout =
-				(key.IsColorCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal;
+				(actions.ColorLoadActions[i] != LoadAction::Load) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal;
 			attachmentDescs.at(i).finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 		}
 	}
 
+	// a resolved depth is ignored if it is not supported
+	const bool hasResolvedDepth = hasDepth && key.HasResolvedDepthTarget && isDepthResolveEnabled_;
+
 	// depth buffer
 	if (hasDepth)
 	{
 		attachmentDescs.at(colorCount).format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.DepthFormat);
 		attachmentDescs.at(colorCount).samples = (vk::SampleCountFlagBits)key.SamplingCount;
 
-		if (key.IsDepthCleared)
-		{
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eClear;
-			attachmentDescs.at(colorCount).stencilLoadOp = vk::AttachmentLoadOp::eClear;
-		}
-		else
-		{
-			attachmentDescs.at(colorCount).loadOp = vk::AttachmentLoadOp::eDontCare;
-			attachmentDescs.at(colorCount).stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-		}
-
-		attachmentDescs.at(colorCount).storeOp = vk::AttachmentStoreOp::eDontCare;
-		attachmentDescs.at(colorCount).stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-
-		// When clearing, the initialLayout does not matter.
-		attachmentDescs.at(colorCount).initialLayout =
-			(key.IsDepthCleared) ? vk::ImageLayout::eUndefined : vk::ImageLayout::eDepthStencilAttachmentOptimal;
-		attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-		// attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+		// stencil follows depth
+		attachmentDescs.at(colorCount).loadOp = RenderPassActionsVulkan::GetLoadOp(actions.DepthLoadAction);
+		attachmentDescs.at(colorCount).stencilLoadOp = RenderPassActionsVulkan::GetLoadOp(actions.DepthLoadAction);
+		attachmentDescs.at(colorCount).storeOp = RenderPassActionsVulkan::GetStoreOp(actions.DepthStoreAction, hasResolvedDepth);
+		attachmentDescs.at(colorCount).stencilStoreOp = attachmentDescs.at(colorCount).storeOp;
+
+		// When not loading, the initialLayout does not matter.
+		// depth is left readable so that a depth only pass (e.g. shadow map) can be sampled afterwards
+		attachmentDescs.at(colorCount).initialLayout = (actions.DepthLoadAction != LoadAction::Load)
+														   ? vk::ImageLayout::eUndefined
+														   : vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+		attachmentDescs.at(colorCount).finalLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
 	}
 
 	// resolve
@@ -123,20 +127,21 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		desc.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 	}
 
-	// int32_t resolveDepthIndex = -1;
-	if (key.HasResolvedDepthTarget)
+	int32_t resolveDepthIndex = -1;
+	if (hasResolvedDepth)
 	{
-		// Wait 1.2
-		// attachmentDescs.resize(attachmentDescs.size() + 1);
-		// auto& desc = attachmentDescs.at(attachmentDescs.size() - 1);
-		// resolveDepthIndex = static_cast<int32_t>(attachmentDescs.size()) - 1;
-		//
-		// desc.format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.DepthFormat);
-		// desc.samples = vk::SampleCountFlagBits::e1;
-		// desc.loadOp = vk::AttachmentLoadOp::eDontCare;
-		// desc.storeOp = vk::AttachmentStoreOp::eStore;
-		// desc.initialLayout = vk::ImageLayout::eUndefined;
-		// desc.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		attachmentDescs.resize(attachmentDescs.size() + 1);
+		auto& desc = attachmentDescs.at(attachmentDescs.size() - 1);
+		resolveDepthIndex = static_cast<int32_t>(attachmentDescs.size()) - 1;
+
+		desc.format = (vk::Format)VulkanHelper::TextureFormatToVkFormat(key.DepthFormat);
+		desc.samples = vk::SampleCountFlagBits::e1;
+		desc.loadOp = vk::AttachmentLoadOp::eDontCare;
+		desc.storeOp = vk::AttachmentStoreOp::eStore;
+		desc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+		desc.stencilStoreOp = vk::AttachmentStoreOp::eStore;
+		desc.initialLayout = vk::ImageLayout::eUndefined;
+		desc.finalLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
 	}
 
 	for (int i = 0; i < colorCount; i++)
@@ -161,13 +166,12 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		ref.layout = vk::ImageLayout::eColorAttachmentOptimal;
 	}
 
-	if (key.HasResolvedDepthTarget)
+	if (hasResolvedDepth)
 	{
-		// Wait 1.2
-		// attachmentRefs.resize(attachmentRefs.size() + 1);
-		// auto& ref = attachmentRefs.at(attachmentRefs.size() - 1);
-		// ref.attachment = resolveDepthIndex;
-		// ref.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		attachmentRefs.resize(attachmentRefs.size() + 1);
+		auto& ref = attachmentRefs.at(attachmentRefs.size() - 1);
+		ref.attachment = resolveDepthIndex;
+		ref.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
 	}
 
 	finalLayouts.resize(attachmentDescs.size());
@@ -182,7 +186,7 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		vk::SubpassDescription& subpass = subpasses[0];
 		subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
 		subpass.colorAttachmentCount = colorCount;
-		subpass.pColorAttachments = &attachmentRefs.at(0);
+		subpass.pColorAttachments = colorCount > 0 ? &attachmentRefs.at(0) : nullptr;
 
 		if (hasDepth)
 		{
@@ -198,13 +202,11 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 			subpass.pResolveAttachments = &attachmentRefs.at(resolveIndex);
 		}
 
-		if (key.HasResolvedDepthTarget)
-		{
-			// Wait 1.2
-		}
+		// a resolved depth is specified in CreateRenderPass2
 	}
 
-	std::array<vk::SubpassDependency, RenderTargetMax * 2> dependencies;
+	std::array<vk::SubpassDependency, RenderTargetMax * 2 + 2> dependencies;
+	uint32_t dependencyCount = 0;
 
 	if (!key.IsPresent)
 	{
@@ -226,6 +228,43 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 			dependencies[i * 2 + 1].dstAccessMask = (vk::AccessFlags)VK_ACCESS_SHADER_READ_BIT;
 			dependencies[i * 2 + 1].dependencyFlags = (vk::DependencyFlags)VK_DEPENDENCY_BY_REGION_BIT;
 		}
+
+		dependencyCount = static_cast<uint32_t>(colorCount * 2);
+	}
+
+	if (hasDepth)
+	{
+		auto& before = dependencies[dependencyCount + 0];
+		before.srcSubpass = VK_SUBPASS_EXTERNAL;
+		before.dstSubpass = 0;
+		before.srcStageMask = (vk::PipelineStageFlags)VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		before.dstStageMask =
+			(vk::PipelineStageFlags)(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+		before.srcAccessMask = (vk::AccessFlags)VK_ACCESS_SHADER_READ_BIT;
+		before.dstAccessMask =
+			(vk::AccessFlags)(VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+		before.dependencyFlags = (vk::DependencyFlags)VK_DEPENDENCY_BY_REGION_BIT;
+
+		auto& after = dependencies[dependencyCount + 1];
+		after.srcSubpass = 0;
+		after.dstSubpass = VK_SUBPASS_EXTERNAL;
+		after.srcStageMask =
+			(vk::PipelineStageFlags)(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+		after.dstStageMask = (vk::PipelineStageFlags)VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		after.srcAccessMask = (vk::AccessFlags)VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		after.dstAccessMask = (vk::AccessFlags)VK_ACCESS_SHADER_READ_BIT;
+		after.dependencyFlags = (vk::DependencyFlags)VK_DEPENDENCY_BY_REGION_BIT;
+
+		// a resolve of depth is executed in a stage of color attachments
+		if (hasResolvedDepth)
+		{
+			before.dstStageMask |= vk::PipelineStageFlagBits::eColorAttachmentOutput;
+			before.dstAccessMask |= vk::AccessFlagBits::eColorAttachmentWrite;
+			after.srcStageMask |= vk::PipelineStageFlagBits::eColorAttachmentOutput;
+			after.srcAccessMask |= vk::AccessFlagBits::eColorAttachmentWrite;
+		}
+
+		dependencyCount += 2;
 	}
 
 	{
@@ -236,37 +275,213 @@ RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const
 		renderPassInfo.subpassCount = (uint32_t)subpasses.size();
 		renderPassInfo.pSubpasses = subpasses.data();
 
-		if (!key.IsPresent)
+		renderPassInfo.dependencyCount = dependencyCount;
+		renderPassInfo.pDependencies = dependencyCount > 0 ? dependencies.data() : nullptr;
+
+		if (hasResolvedDepth)
 		{
-			renderPassInfo.dependencyCount = static_cast<uint32_t>(colorCount * 2);
-			renderPassInfo.pDependencies = dependencies.data();
+			return CreateRenderPass2(renderPassInfo, static_cast<uint32_t>(resolveDepthIndex));
 		}
-		else
+
+		return device_.createRenderPass(renderPassInfo);
+	}
+}
+
+vk::RenderPass RenderPassPipelineStateCacheVulkan::CreateRenderPass2(const vk::RenderPassCreateInfo& createInfo, uint32_t resolveDepthIndex)
+{
+#if defined(VK_VERSION_1_2)
+	if (createRenderPass2_ == nullptr || createInfo.subpassCount != 1)
+	{
+		return vk::RenderPass();
+	}
+
+	auto convertReference = [](const vk::AttachmentReference& reference) -> VkAttachmentReference2 {
+		VkAttachmentReference2 ret = {};
+		ret.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+		ret.attachment = reference.attachment;
+		ret.layout = static_cast<VkImageLayout>(reference.layout);
+		return ret;
+	};
+
+	std::array<VkAttachmentDescription2, RenderTargetMax + 1> attachments = {};
+	for (uint32_t i = 0; i < createInfo.attachmentCount; i++)
+	{
+		const auto& src = createInfo.pAttachments[i];
+		auto& dst = attachments[i];
+		dst.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2;
+		dst.format = static_cast<VkFormat>(src.format);
+		dst.samples = static_cast<VkSampleCountFlagBits>(src.samples);
+		dst.loadOp = static_cast<VkAttachmentLoadOp>(src.loadOp);
+		dst.storeOp = static_cast<VkAttachmentStoreOp>(src.storeOp);
+		dst.stencilLoadOp = static_cast<VkAttachmentLoadOp>(src.stencilLoadOp);
+		dst.stencilStoreOp = static_cast<VkAttachmentStoreOp>(src.stencilStoreOp);
+		dst.initialLayout = static_cast<VkImageLayout>(src.initialLayout);
+		dst.finalLayout = static_cast<VkImageLayout>(src.finalLayout);
+	}
+
+	const auto& subpass = createInfo.pSubpasses[0];
+	std::array<VkAttachmentReference2, RenderTargetMax> colorReferences = {};
+	std::array<VkAttachmentReference2, RenderTargetMax> resolveReferences = {};
+	VkAttachmentReference2 depthReference = {};
+
+	for (uint32_t i = 0; i < subpass.colorAttachmentCount; i++)
+	{
+		colorReferences[i] = convertReference(subpass.pColorAttachments[i]);
+
+		if (subpass.pResolveAttachments != nullptr)
 		{
-			renderPassInfo.dependencyCount = 0;
-			renderPassInfo.pDependencies = nullptr;
+			resolveReferences[i] = convertReference(subpass.pResolveAttachments[i]);
 		}
+	}
+
+	if (subpass.pDepthStencilAttachment != nullptr)
+	{
+		depthReference = convertReference(*subpass.pDepthStencilAttachment);
+	}
+
+	VkAttachmentReference2 resolveDepthReference = {};
+	resolveDepthReference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+	resolveDepthReference.attachment = resolveDepthIndex;
+	resolveDepthReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	// a sample zero is supported with all formats, other modes are optional
+	VkSubpassDescriptionDepthStencilResolve depthStencilResolve = {};
+	depthStencilResolve.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_DEPTH_STENCIL_RESOLVE;
+	depthStencilResolve.depthResolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+	depthStencilResolve.stencilResolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+	depthStencilResolve.pDepthStencilResolveAttachment = &resolveDepthReference;
+
+	VkSubpassDescription2 subpass2 = {};
+	subpass2.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2;
+	subpass2.pNext = &depthStencilResolve;
+	subpass2.pipelineBindPoint = static_cast<VkPipelineBindPoint>(subpass.pipelineBindPoint);
+	subpass2.colorAttachmentCount = subpass.colorAttachmentCount;
+	subpass2.pColorAttachments = subpass.colorAttachmentCount > 0 ? colorReferences.data() : nullptr;
+	subpass2.pResolveAttachments = subpass.pResolveAttachments != nullptr ? resolveReferences.data() : nullptr;
+	subpass2.pDepthStencilAttachment = subpass.pDepthStencilAttachment != nullptr ? &depthReference : nullptr;
+
+	std::array<VkSubpassDependency2, RenderTargetMax * 2 + 2> dependencies = {};
+	for (uint32_t i = 0; i < createInfo.dependencyCount; i++)
+	{
+		const auto& src = createInfo.pDependencies[i];
+		auto& dst = dependencies[i];
+		dst.sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2;
+		dst.srcSubpass = src.srcSubpass;
+		dst.dstSubpass = src.dstSubpass;
+		dst.srcStageMask = static_cast<VkPipelineStageFlags>(src.srcStageMask);
+		dst.dstStageMask = static_cast<VkPipelineStageFlags>(src.dstStageMask);
+		dst.srcAccessMask = static_cast<VkAccessFlags>(src.srcAccessMask);
+		dst.dstAccessMask = static_cast<VkAccessFlags>(src.dstAccessMask);
+		dst.dependencyFlags = static_cast<VkDependencyFlags>(src.dependencyFlags);
+	}
 
-		auto renderPass = device_.createRenderPass(renderPassInfo);
+	VkRenderPassCreateInfo2 createInfo2 = {};
+	createInfo2.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2;
+	createInfo2.attachmentCount = createInfo.attachmentCount;
+	createInfo2.pAttachments = attachments.data();
+	createInfo2.subpassCount = 1;
+	createInfo2.pSubpasses = &subpass2;
+	createInfo2.dependencyCount = createInfo.dependencyCount;
+	createInfo2.pDependencies = createInfo.dependencyCount > 0 ? dependencies.data() : nullptr;
+
+	VkRenderPass renderPass = VK_NULL_HANDLE;
+	if (createRenderPass2_(static_cast<VkDevice>(device_), &createInfo2, nullptr, &renderPass) != VK_SUCCESS)
+	{
+		Log(LogType::Error, "Failed to create a render pass which resolves depth.");
+		return vk::RenderPass();
+	}
+
+	return vk::RenderPass(renderPass);
+#else
+	return vk::RenderPass();
+#endif
+}
+
+RenderPassPipelineStateVulkan* RenderPassPipelineStateCacheVulkan::Create(const RenderPassPipelineStateKey key)
+{
+	// already?
+	{
+		auto it = renderPassPipelineStates_.find(key);
+
+		if (it != renderPassPipelineStates_.end())
+		{
+			auto ret = it->second;
+
+			if (ret != nullptr)
+			{
+				auto retptr = ret.get();
+				SafeAddRef(retptr);
+				return retptr;
+			}
+		}
+	}
+
+	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts;
+	const auto actions = RenderPassActionsVulkan::Create(key);
+	std::shared_ptr<RenderPassPipelineStateVulkan> ret = CreateSharedPtr(new RenderPassPipelineStateVulkan(device_, owner_));
+
+	// pipelines are created only with formats and render passes are not required
+	if (isDynamicRenderingEnabled_)
+	{
+		ret->IsDynamicRendering = true;
+	}
+	else
+	{
+		auto renderPass = CreateRenderPass(key, actions, finalLayouts);
 		if (!renderPass)
 		{
 			return nullptr;
 		}
 
-		std::shared_ptr<RenderPassPipelineStateVulkan> ret = CreateSharedPtr(new RenderPassPipelineStateVulkan(device_, owner_));
 		ret->renderPass_ = renderPass;
+		ret->renderPasses_[actions.GetKey()] = renderPass;
 		ret->finalLayouts_ = finalLayouts;
-		renderPassPipelineStates_[key] = ret;
+	}
+	renderPassPipelineStates_[key] = ret;
 
-		auto retptr = ret.get();
-		SafeAddRef(retptr);
+	auto retptr = ret.get();
+	SafeAddRef(retptr);
 
-		retptr->RenderTargetCount = colorCount;
+	retptr->RenderTargetCount = static_cast<int32_t>(key.RenderTargetFormats.size());
 
-		retptr->Key = key;
+	retptr->Key = key;
 
-		return retptr;
+	return retptr;
+}
+
+vk::RenderPass RenderPassPipelineStateCacheVulkan::GetRenderPass(RenderPassPipelineStateVulkan* renderPassPipelineState,
+																 const RenderPassActionsVulkan& actions)
+{
+	const auto operationKey = actions.GetKey();
+
+	auto it = renderPassPipelineState->renderPasses_.find(operationKey);
+	if (it != renderPassPipelineState->renderPasses_.end())
+	{
+		return it->second;
+	}
+
+	// a variant is compatible with a render pass which pipelines were created with
+	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts;
+	auto renderPass = CreateRenderPass(renderPassPipelineState->Key, actions, finalLayouts);
+	if (!renderPass)
+	{
+		return renderPassPipelineState->GetRenderPass();
 	}
+
+	renderPassPipelineState->renderPasses_[operationKey] = renderPass;
+	return renderPass;
+}
+
+#if defined(VK_VERSION_1_3)
+void RenderPassPipelineStateCacheVulkan::BeginRendering(vk::CommandBuffer commandBuffer, const VkRenderingInfo& renderingInfo) const
+{
+	cmdBeginRendering_(static_cast<VkCommandBuffer>(commandBuffer), &renderingInfo);
+}
+
+void RenderPassPipelineStateCacheVulkan::EndRendering(vk::CommandBuffer commandBuffer) const
+{
+	cmdEndRendering_(static_cast<VkCommandBuffer>(commandBuffer));
 }
+#endif
 
 } // namespace LLGI
@@ -3,6 +3,7 @@
 #include "../LLGI.Graphics.h"
 #include "../Utils/LLGI.FixedSizeVector.h"
 #include "LLGI.BaseVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
 #include "LLGI.RenderPassVulkan.h"
 #include <functional>
 #include <unordered_map>
@@ -19,11 +20,65 @@ private:
 	vk::Device device_;
 	ReferenceObject* owner_ = nullptr;
 
+	std::shared_ptr<FramebufferCacheVulkan> framebufferCache_;
+
+	bool isDynamicRenderingEnabled_ = false;
+	bool isDepthResolveEnabled_ = false;
+
+#if defined(VK_VERSION_1_2)
+	PFN_vkCreateRenderPass2 createRenderPass2_ = nullptr;
+#endif
+
+#if defined(VK_VERSION_1_3)
+	PFN_vkCmdBeginRendering cmdBeginRendering_ = nullptr;
+	PFN_vkCmdEndRendering cmdEndRendering_ = nullptr;
+#endif
+
+	vk::RenderPass CreateRenderPass(const RenderPassPipelineStateKey& key,
+									const RenderPassActionsVulkan& actions,
+									FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1>& finalLayouts);
+
+	//! create a render pass with structures of Vulkan 1.2, which can resolve depth
+	vk::RenderPass CreateRenderPass2(const vk::RenderPassCreateInfo& createInfo, uint32_t resolveDepthIndex);
+
 public:
-	RenderPassPipelineStateCacheVulkan(vk::Device device, ReferenceObject* owner);
+	/**
+		@param	isDynamicRenderingEnabled	whether render passes are begun with vkCmdBeginRendering without render pass objects
+		@param	isDepthResolveEnabled	whether depth is resolved in render passes
+		@param	commandQueue	a queue which is used to destroy evicted framebuffers after gpu finishes using them
+		@note
+		isDynamicRenderingEnabled is ignored if the device is not created with a dynamic rendering feature.
+		isDepthResolveEnabled is ignored if the device does not support Vulkan 1.2.
+	*/
+	RenderPassPipelineStateCacheVulkan(vk::Device device,
+									   ReferenceObject* owner,
+									   bool isDynamicRenderingEnabled = false,
+									   bool isDepthResolveEnabled = false,
+									   CommandQueueVulkan* commandQueue = nullptr);
 	~RenderPassPipelineStateCacheVulkan() override;
 
 	RenderPassPipelineStateVulkan* Create(const RenderPassPipelineStateKey key);
+
+	/**
+		@brief	get a render pass with actions, which is compatible with a render pass of renderPassPipelineState
+		@note
+		It is created when it is required at first.
+	*/
+	vk::RenderPass GetRenderPass(RenderPassPipelineStateVulkan* renderPassPipelineState, const RenderPassActionsVulkan& actions);
+
+	//! framebuffers which are shared among render passes created with this cache
+	FramebufferCacheVulkan* GetFramebufferCache() const { return framebufferCache_.get(); }
+
+	bool GetIsDynamicRenderingEnabled() const { return isDynamicRenderingEnabled_; }
+
+	//! whether a multisampled depth texture is resolved in a render pass
+	bool GetIsDepthResolveEnabled() const { return isDepthResolveEnabled_; }
+
+#if defined(VK_VERSION_1_3)
+	void BeginRendering(vk::CommandBuffer commandBuffer, const VkRenderingInfo& renderingInfo) const;
+
+	void EndRendering(vk::CommandBuffer commandBuffer) const;
+#endif
 };
 
 } // namespace LLGI
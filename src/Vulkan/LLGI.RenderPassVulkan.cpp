@@ -5,6 +5,7 @@
 #include "LLGI.GraphicsVulkan.h"
 #include "LLGI.IndexBufferVulkan.h"
 #include "LLGI.PipelineStateVulkan.h"
+#include "LLGI.RenderPassPipelineStateCacheVulkan.h"
 #include "LLGI.ShaderVulkan.h"
 #include "LLGI.SingleFrameMemoryPoolVulkan.h"
 #include "LLGI.TextureVulkan.h"
@@ -24,10 +25,7 @@ RenderPassVulkan::RenderPassVulkan(RenderPassPipelineStateCacheVulkan* renderPas
 
 RenderPassVulkan::~RenderPassVulkan()
 {
-	if (frameBuffer_)
-	{
-		device_.destroyFramebuffer(frameBuffer_);
-	}
+	// frameBuffer_ is owned by a framebuffer cache
 
 	SafeRelease(renderPassPipelineState);
 	SafeRelease(renderPassPipelineStateCache_);
@@ -40,7 +38,8 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
 								  TextureVulkan* resolvedTexture,
 								  TextureVulkan* resolvedDepthTexture)
 {
-	if (textureCount == 0)
+	// a depth only pass is allowed
+	if (textureCount == 0 && depthTexture == nullptr)
 		return false;
 
 	if (!assignRenderTextures((Texture**)(textures), textureCount))
@@ -58,6 +57,12 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
 		return false;
 	}
 
+	if (resolvedDepthTexture != nullptr && !renderPassPipelineStateCache_->GetIsDepthResolveEnabled())
+	{
+		Log(LogType::Error, "RenderPass : Resolving depth is not supported.");
+		return false;
+	}
+
 	if (!assignResolvedDepthTexture(resolvedDepthTexture))
 	{
 		return false;
@@ -87,60 +92,69 @@ bool RenderPassVulkan::Initialize(const TextureVulkan** textures,
 		renderTargetProperties.at(i).format = textures[i]->GetVulkanFormat();
 	}
 
-	FixedSizeVector<vk::ImageView, RenderTargetMax + 1> views;
+	FramebufferCacheVulkan::Key framebufferKey;
+	FixedSizeVector<TextureVulkan*, RenderTargetMax + 2> attachments;
+	auto& views = framebufferKey.Views;
 	views.resize(textureCount);
+	attachments.resize(textureCount);
 
 	for (int32_t i = 0; i < textureCount; i++)
 	{
 		views.at(i) = textures[i]->GetView();
+		attachments.at(i) = const_cast<TextureVulkan*>(textures[i]);
 	}
 
 	if (GetHasDepthTexture())
 	{
 		views.resize(views.size() + 1);
 		views.at(views.size() - 1) = depthTexture->GetView();
+		attachments.resize(attachments.size() + 1);
+		attachments.at(attachments.size() - 1) = depthTexture;
 	}
 
 	if (auto resolvedTextureVulkan = static_cast<TextureVulkan*>(GetResolvedRenderTexture()))
 	{
 		views.resize(views.size() + 1);
 		views.at(views.size() - 1) = resolvedTextureVulkan->GetView();
+		attachments.resize(attachments.size() + 1);
+		attachments.at(attachments.size() - 1) = resolvedTextureVulkan;
 	}
 
-	// if (auto resolvedTextureVulkan = static_cast<TextureVulkan*>(GetResolvedDepthTexture()))
-	//{
-	// Wait 1.2
-	// views.resize(views.size() + 1);
-	// views.at(views.size() - 1) = resolvedTexture->GetView();
-	//}
+	if (auto resolvedDepthTextureVulkan = static_cast<TextureVulkan*>(GetResolvedDepthTexture()))
+	{
+		views.resize(views.size() + 1);
+		views.at(views.size() - 1) = resolvedDepthTextureVulkan->GetView();
+		attachments.resize(attachments.size() + 1);
+		attachments.at(attachments.size() - 1) = resolvedDepthTextureVulkan;
+	}
 
 	ResetRenderPassPipelineState();
 
-	vk::FramebufferCreateInfo framebufferCreateInfo;
-	framebufferCreateInfo.renderPass = renderPassPipelineState->GetRenderPass();
-	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
-	framebufferCreateInfo.pAttachments = views.data();
-	framebufferCreateInfo.width = screenSize_.X;
-	framebufferCreateInfo.height = screenSize_.Y;
-	framebufferCreateInfo.layers = 1;
+	// attachments are specified when it is begun
+	if (GetIsDynamicRendering())
+	{
+		return true;
+	}
 
-	frameBuffer_ = device_.createFramebuffer(framebufferCreateInfo);
+	// a framebuffer is shared with render passes which have same attachments
+	framebufferKey.RenderPassKey = GetKey();
+	framebufferKey.Size = screenSize_;
+	frameBuffer_ = renderPassPipelineStateCache_->GetFramebufferCache()->Get(
+		framebufferKey, renderPassPipelineState->GetRenderPass(), attachments.data(), static_cast<int32_t>(attachments.size()));
 
 	return true;
 }
 
 Vec2I RenderPassVulkan::GetImageSize() const { return screenSize_; }
 
-void RenderPassVulkan::SetIsColorCleared(bool isColorCleared)
+bool RenderPassVulkan::GetIsDynamicRendering() const
 {
-	RenderPass::SetIsColorCleared(isColorCleared);
-	ResetRenderPassPipelineState();
+	return renderPassPipelineState != nullptr && renderPassPipelineState->IsDynamicRendering;
 }
 
-void RenderPassVulkan::SetIsDepthCleared(bool isDepthCleared)
+vk::RenderPass RenderPassVulkan::GetRenderPassToBegin() const
 {
-	RenderPass::SetIsDepthCleared(isDepthCleared);
-	ResetRenderPassPipelineState();
+	return renderPassPipelineStateCache_->GetRenderPass(renderPassPipelineState, RenderPassActionsVulkan::Create(this));
 }
 
 void RenderPassVulkan::ResetRenderPassPipelineState()
@@ -166,10 +180,12 @@ RenderPassPipelineStateVulkan::RenderPassPipelineStateVulkan(vk::Device device,
 
 RenderPassPipelineStateVulkan::~RenderPassPipelineStateVulkan()
 {
-	if (renderPass_)
+	// renderPass_ is one of them
+	for (auto& renderPass : renderPasses_)
 	{
-		device_.destroyRenderPass(renderPass_);
+		device_.destroyRenderPass(renderPass.second);
 	}
+	renderPasses_.clear();
 
 	SafeRelease(owner_);
 }
@@ -14,6 +14,92 @@ class RenderPassPipelineStateVulkan;
 class RenderPassPipelineStateCacheVulkan;
 class TextureVulkan;
 
+/**
+	@brief	load and store actions of attachments
+	@note
+	They do not change compatibility of render passes, so they are applied only to a render pass which is used to begin.
+*/
+struct RenderPassActionsVulkan
+{
+	std::array<LoadAction, RenderTargetMax> ColorLoadActions;
+	std::array<StoreAction, RenderTargetMax> ColorStoreActions;
+	LoadAction DepthLoadAction = LoadAction::DontCare;
+	StoreAction DepthStoreAction = StoreAction::Store;
+
+	//! same as defaults of RenderPass
+	RenderPassActionsVulkan()
+	{
+		ColorLoadActions.fill(LoadAction::DontCare);
+		ColorStoreActions.fill(StoreAction::Store);
+	}
+
+	//! a unique value of actions, 4 bits are used for each attachment
+	uint64_t GetKey() const
+	{
+		uint64_t key = 0;
+		for (int32_t i = 0; i < RenderTargetMax; i++)
+		{
+			const auto actions = static_cast<int32_t>(ColorLoadActions[i]) | (static_cast<int32_t>(ColorStoreActions[i]) << 2);
+			key |= static_cast<uint64_t>(actions) << (i * 4);
+		}
+
+		key |= static_cast<uint64_t>(static_cast<int32_t>(DepthLoadAction) | (static_cast<int32_t>(DepthStoreAction) << 2))
+			   << (RenderTargetMax * 4);
+		return key;
+	}
+
+	static RenderPassActionsVulkan Create(const RenderPass* renderPass)
+	{
+		RenderPassActionsVulkan actions;
+		for (int32_t i = 0; i < RenderTargetMax; i++)
+		{
+			actions.ColorLoadActions[i] = renderPass->GetColorLoadAction(i);
+			actions.ColorStoreActions[i] = renderPass->GetColorStoreAction(i);
+		}
+
+		actions.DepthLoadAction = renderPass->GetDepthLoadAction();
+		actions.DepthStoreAction = renderPass->GetDepthStoreAction();
+		return actions;
+	}
+
+	static RenderPassActionsVulkan Create(const RenderPassPipelineStateKey& key)
+	{
+		RenderPassActionsVulkan actions;
+		actions.ColorLoadActions.fill(key.IsColorCleared ? LoadAction::Clear : LoadAction::DontCare);
+		actions.DepthLoadAction = key.IsDepthCleared ? LoadAction::Clear : LoadAction::DontCare;
+		return actions;
+	}
+
+	static vk::AttachmentLoadOp GetLoadOp(LoadAction action)
+	{
+		switch (action)
+		{
+		case LoadAction::Load:
+			return vk::AttachmentLoadOp::eLoad;
+		case LoadAction::Clear:
+			return vk::AttachmentLoadOp::eClear;
+		default:
+			return vk::AttachmentLoadOp::eDontCare;
+		}
+	}
+
+	/**
+		@brief	get an operation of an attachment
+		@param	isResolved	whether the attachment has a resolve target, Resolve is rejected and contents are stored without it
+	*/
+	static vk::AttachmentStoreOp GetStoreOp(StoreAction action, bool isResolved)
+	{
+		if (action == StoreAction::Resolve && !isResolved)
+		{
+			Log(LogType::Error, "RenderPass : Resolve is rejected without a resolve target.");
+			return vk::AttachmentStoreOp::eStore;
+		}
+
+		// a resolve attachment is stored separately
+		return action == StoreAction::Store ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+	}
+};
+
 class RenderPassVulkan : public RenderPass
 {
 private:
@@ -50,9 +136,13 @@ public:
 
 	Vec2I GetImageSize() const;
 
-	virtual void SetIsColorCleared(bool isColorCleared) override;
+	//! a render pass which is used to begin, load and store actions are applied to it
+	vk::RenderPass GetRenderPassToBegin() const;
 
-	virtual void SetIsDepthCleared(bool isDepthCleared) override;
+	RenderPassPipelineStateCacheVulkan* GetRenderPassPipelineStateCache() const { return renderPassPipelineStateCache_; }
+
+	//! whether this is begun with vkCmdBeginRendering, frameBuffer_ is not created in this case
+	bool GetIsDynamicRendering() const;
 
 private:
 	void ResetRenderPassPipelineState();
@@ -69,10 +159,18 @@ public:
 
 	~RenderPassPipelineStateVulkan() override;
 
+	//! a render pass which pipelines are created with
 	vk::RenderPass renderPass_;
+
+	//! compatible render passes for each RenderPassActionsVulkan::GetKey, which include renderPass_
+	std::unordered_map<uint64_t, vk::RenderPass> renderPasses_;
+
 	int32_t RenderTargetCount = 0;
 	FixedSizeVector<vk::ImageLayout, RenderTargetMax + 1> finalLayouts_;
 
+	//! whether pipelines are created with formats of Key instead of renderPass_, which is null in this case
+	bool IsDynamicRendering = false;
+
 	vk::RenderPass GetRenderPass() const;
 };
 
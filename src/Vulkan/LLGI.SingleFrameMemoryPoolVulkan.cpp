@@ -1,5 +1,7 @@
 #include "LLGI.SingleFrameMemoryPoolVulkan.h"
 #include "LLGI.ConstantBufferVulkan.h"
+#include "LLGI.IndexBufferVulkan.h"
+#include "LLGI.VertexBufferVulkan.h"
 
 namespace LLGI
 {
@@ -8,67 +10,198 @@ InternalSingleFrameMemoryPoolVulkan::InternalSingleFrameMemoryPoolVulkan() {}
 
 InternalSingleFrameMemoryPoolVulkan ::~InternalSingleFrameMemoryPoolVulkan() {}
 
-bool InternalSingleFrameMemoryPoolVulkan::Initialize(GraphicsVulkan* graphics, int32_t constantBufferPoolSize, int32_t drawingCount)
+bool InternalSingleFrameMemoryPoolVulkan::AddPage(PageChain& chain, int32_t size)
 {
-	constantBufferSize_ = (constantBufferPoolSize + 255) & ~255; // buffer size should be multiple of 256
-
-	nativeDevice_ = static_cast<VkDevice>(graphics->GetDevice());
+	Page page;
+	page.size = static_cast<int32_t>(GetAlignedSize(size, 256)); // buffer size should be multiple of 256
 
 	VkBufferCreateInfo bufferInfo = {};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferInfo.size = constantBufferSize_;
-	bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT; // for constant buffer
+	bufferInfo.size = page.size;
+	bufferInfo.usage = chain.usage;
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-	LLGI_VK_CHECK(vkCreateBuffer(nativeDevice_, &bufferInfo, nullptr, &nativeBuffer_));
+	LLGI_VK_CHECK(vkCreateBuffer(nativeDevice_, &bufferInfo, nullptr, &page.buffer));
 
 	VkMemoryRequirements memRequirements;
-	vkGetBufferMemoryRequirements(nativeDevice_, nativeBuffer_, &memRequirements);
+	vkGetBufferMemoryRequirements(nativeDevice_, page.buffer, &memRequirements);
 
+	// coherent memory is required because it is mapped persistently and not flushed
 	VkMemoryAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
 	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = graphics->GetMemoryTypeIndex(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
+	allocInfo.memoryTypeIndex = graphics_->GetMemoryTypeIndex(
+		memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	if (vkAllocateMemory(nativeDevice_, &allocInfo, nullptr, &page.memory) != VK_SUCCESS)
+	{
+		vkDestroyBuffer(nativeDevice_, page.buffer, nullptr);
+		Log(LogType::Error, "SingleFrameMemoryPool : Failed to allocate a page.");
+		return false;
+	}
 
-	LLGI_VK_CHECK(vkAllocateMemory(nativeDevice_, &allocInfo, nullptr, &nativeBufferMemory_));
+	LLGI_VK_CHECK(vkBindBufferMemory(nativeDevice_, page.buffer, page.memory, 0));
 
-	LLGI_VK_CHECK(vkBindBufferMemory(nativeDevice_, nativeBuffer_, nativeBufferMemory_, 0));
+	void* mapped = nullptr;
+	LLGI_VK_CHECK(vkMapMemory(nativeDevice_, page.memory, 0, VK_WHOLE_SIZE, 0, &mapped));
+	page.mapped = static_cast<uint8_t*>(mapped);
 
+	chain.pages.push_back(page);
 	return true;
 }
 
-void InternalSingleFrameMemoryPoolVulkan::Dispose()
+void InternalSingleFrameMemoryPoolVulkan::DisposePages(PageChain& chain)
 {
-	if (nativeBufferMemory_)
+	for (auto& page : chain.pages)
 	{
-		vkFreeMemory(nativeDevice_, nativeBufferMemory_, nullptr);
-		nativeBufferMemory_ = VK_NULL_HANDLE;
+		vkUnmapMemory(nativeDevice_, page.memory);
+		vkFreeMemory(nativeDevice_, page.memory, nullptr);
+		vkDestroyBuffer(nativeDevice_, page.buffer, nullptr);
+	}
+	chain.pages.clear();
+	chain.pageIndex = 0;
+	chain.offset = 0;
+}
+
+bool InternalSingleFrameMemoryPoolVulkan::Allocate(
+	PageChain& chain, int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped)
+{
+	auto alignedSize = static_cast<int32_t>(GetAlignedSize(size, chain.alignment));
+
+	while (true)
+	{
+		if (chain.pageIndex < static_cast<int32_t>(chain.pages.size()))
+		{
+			auto& page = chain.pages[chain.pageIndex];
+			if (chain.offset + alignedSize <= page.size)
+			{
+				*outResource = page.buffer;
+				*deviceMemory = page.memory;
+				*outOffset = chain.offset;
+				*outMapped = page.mapped + chain.offset;
+				chain.offset += alignedSize;
+				chain.usedSize += alignedSize;
+				chain.requestedSize += size;
+				chain.allocationCount++;
+				return true;
+			}
+
+			chain.pageIndex++;
+			chain.offset = 0;
+			continue;
+		}
+
+		// all pages are full
+		if (!chain.pages.empty())
+		{
+			growthCount_++;
+		}
+
+		if (!AddPage(chain, std::max(chain.initialSize, alignedSize)))
+		{
+			return false;
+		}
 	}
+}
 
-	if (nativeBuffer_)
+void InternalSingleFrameMemoryPoolVulkan::Reset(PageChain& chain, bool shrink)
+{
+	if (chain.pages.size() > 1)
+	{
+		// merge pages into a page which can contain memory used in the last frame
+		auto size = std::max(chain.initialSize, chain.usedSize);
+		DisposePages(chain);
+		AddPage(chain, size);
+	}
+	else if (shrink && chain.pages.size() == 1 && chain.pages[0].size > static_cast<int32_t>(GetAlignedSize(chain.initialSize, 256)))
 	{
-		vkDestroyBuffer(nativeDevice_, nativeBuffer_, nullptr);
-		nativeBuffer_ = VK_NULL_HANDLE;
+		DisposePages(chain);
+		AddPage(chain, chain.initialSize);
+		shrinkCount_++;
 	}
 
+	chain.pageIndex = 0;
+	chain.offset = 0;
+	chain.usedSize = 0;
+	chain.requestedSize = 0;
+	chain.allocationCount = 0;
+}
+
+bool InternalSingleFrameMemoryPoolVulkan::Initialize(GraphicsVulkan* graphics, int32_t constantBufferPoolSize, int32_t drawingCount)
+{
+	graphics_ = graphics;
+	nativeDevice_ = static_cast<VkDevice>(graphics->GetDevice());
+
+	constantBuffers_.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+	// constant buffers are packed tightly as the device allows
+	constantBuffers_.alignment = graphics->GetConstantBufferAlignment();
+	constantBuffers_.initialSize = constantBufferPoolSize;
+
+	// an offset of index buffer must be a multiple of index size and vertices are read as 4 byte elements
+	geometryBuffers_.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+	geometryBuffers_.alignment = 16;
+	geometryBuffers_.initialSize = constantBufferPoolSize;
+
+	// a buffer for vertices and indices is created when it is required first
+	return AddPage(constantBuffers_, constantBuffers_.initialSize);
+}
+
+void InternalSingleFrameMemoryPoolVulkan::Dispose()
+{
+	DisposePages(constantBuffers_);
+	DisposePages(geometryBuffers_);
 	nativeDevice_ = VK_NULL_HANDLE;
 }
 
-bool InternalSingleFrameMemoryPoolVulkan::GetConstantBuffer(int32_t size,
-															VkBuffer* outResource,
-															VkDeviceMemory* deviceMemory,
-															int32_t* outOffset)
+bool InternalSingleFrameMemoryPoolVulkan::GetConstantBuffer(
+	int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped)
 {
-	if (constantBufferOffset_ + size > constantBufferSize_)
-		return false;
+	return Allocate(constantBuffers_, size, outResource, deviceMemory, outOffset, outMapped);
+}
 
-	*outResource = nativeBuffer_;
-	*deviceMemory = nativeBufferMemory_;
-	*outOffset = constantBufferOffset_;
-	constantBufferOffset_ += size;
-	return true;
+bool InternalSingleFrameMemoryPoolVulkan::GetGeometryBuffer(
+	int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped)
+{
+	return Allocate(geometryBuffers_, size, outResource, deviceMemory, outOffset, outMapped);
+}
+
+void InternalSingleFrameMemoryPoolVulkan::Reset(bool shrink)
+{
+	Reset(constantBuffers_, shrink);
+	Reset(geometryBuffers_, shrink);
+}
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetUsedSize() const { return constantBuffers_.usedSize + geometryBuffers_.usedSize; }
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetRequestedSize() const
+{
+	return constantBuffers_.requestedSize + geometryBuffers_.requestedSize;
+}
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetAllocationCount() const
+{
+	return constantBuffers_.allocationCount + geometryBuffers_.allocationCount;
+}
+
+int32_t InternalSingleFrameMemoryPoolVulkan::GetReservedSize() const
+{
+	int32_t size = 0;
+	for (const auto& page : constantBuffers_.pages)
+	{
+		size += page.size;
+	}
+
+	for (const auto& page : geometryBuffers_.pages)
+	{
+		size += page.size;
+	}
+
+	return size;
 }
 
-void InternalSingleFrameMemoryPoolVulkan::Reset() { constantBufferOffset_ = 0; }
+bool InternalSingleFrameMemoryPoolVulkan::GetIsGrown() const
+{
+	return constantBuffers_.usedSize > constantBuffers_.initialSize || geometryBuffers_.usedSize > geometryBuffers_.initialSize;
+}
 
 ConstantBuffer* SingleFrameMemoryPoolVulkan::CreateConstantBufferInternal(int32_t size)
 {
@@ -93,6 +226,52 @@ ConstantBuffer* SingleFrameMemoryPoolVulkan::ReinitializeConstantBuffer(Constant
 	return obj;
 }
 
+VertexBuffer* SingleFrameMemoryPoolVulkan::CreateVertexBufferInternal(int32_t size)
+{
+	auto obj = new VertexBufferVulkan();
+	if (!obj->InitializeAsShortTime(graphics_, this, size))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+VertexBuffer* SingleFrameMemoryPoolVulkan::ReinitializeVertexBuffer(VertexBuffer* vb, int32_t size)
+{
+	auto obj = static_cast<VertexBufferVulkan*>(vb);
+	if (!obj->InitializeAsShortTime(graphics_, this, size))
+	{
+		return nullptr;
+	}
+
+	return obj;
+}
+
+IndexBuffer* SingleFrameMemoryPoolVulkan::CreateIndexBufferInternal(int32_t stride, int32_t count)
+{
+	auto obj = new IndexBufferVulkan();
+	if (!obj->InitializeAsShortTime(graphics_, this, stride, count))
+	{
+		SafeRelease(obj);
+		return nullptr;
+	}
+
+	return obj;
+}
+
+IndexBuffer* SingleFrameMemoryPoolVulkan::ReinitializeIndexBuffer(IndexBuffer* ib, int32_t stride, int32_t count)
+{
+	auto obj = static_cast<IndexBufferVulkan*>(ib);
+	if (!obj->InitializeAsShortTime(graphics_, this, stride, count))
+	{
+		return nullptr;
+	}
+
+	return obj;
+}
+
 SingleFrameMemoryPoolVulkan::SingleFrameMemoryPoolVulkan(
 	GraphicsVulkan* graphics, bool isStrongRef, int32_t swapBufferCount, int32_t constantBufferPoolSize, int32_t drawingCount)
 	: SingleFrameMemoryPool(swapBufferCount), graphics_(graphics), isStrongRef_(isStrongRef), currentSwap_(-1), drawingCount_(drawingCount)
@@ -127,10 +306,18 @@ SingleFrameMemoryPoolVulkan ::~SingleFrameMemoryPoolVulkan()
 	}
 }
 
-bool SingleFrameMemoryPoolVulkan::GetConstantBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset)
+bool SingleFrameMemoryPoolVulkan::GetConstantBuffer(
+	int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped)
 {
 	assert(currentSwap_ >= 0);
-	return memoryPools[currentSwap_]->GetConstantBuffer(size, outResource, deviceMemory, outOffset);
+	return memoryPools[currentSwap_]->GetConstantBuffer(size, outResource, deviceMemory, outOffset, outMapped);
+}
+
+bool SingleFrameMemoryPoolVulkan::GetGeometryBuffer(
+	int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped)
+{
+	assert(currentSwap_ >= 0);
+	return memoryPools[currentSwap_]->GetGeometryBuffer(size, outResource, deviceMemory, outOffset, outMapped);
 }
 
 InternalSingleFrameMemoryPoolVulkan* SingleFrameMemoryPoolVulkan::GetInternal() { return memoryPools[currentSwap_].get(); }
@@ -139,10 +326,48 @@ int32_t SingleFrameMemoryPoolVulkan::GetDrawingCount() const { return drawingCou
 
 void SingleFrameMemoryPoolVulkan::NewFrame()
 {
+	if (currentSwap_ >= 0)
+	{
+		const auto& finished = memoryPools[currentSwap_];
+		lastUsedSize_ = finished->GetUsedSize();
+		lastRequestedSize_ = finished->GetRequestedSize();
+		lastAllocationCount_ = finished->GetAllocationCount();
+		highWaterMark_ = std::max(highWaterMark_, lastUsedSize_);
+
+		if (finished->GetIsGrown())
+		{
+			quietFrameCount_ = 0;
+		}
+		else
+		{
+			quietFrameCount_++;
+		}
+	}
+
 	currentSwap_++;
 	currentSwap_ %= memoryPools.size();
-	memoryPools[currentSwap_]->Reset();
+
+	const auto shrink = shrinkFrameCount_ > 0 && quietFrameCount_ >= shrinkFrameCount_;
+	memoryPools[currentSwap_]->Reset(shrink);
 	SingleFrameMemoryPool::NewFrame();
 }
 
+SingleFrameMemoryPoolStatistics SingleFrameMemoryPoolVulkan::GetStatistics() const
+{
+	SingleFrameMemoryPoolStatistics statistics;
+	statistics.UsedSize = lastUsedSize_;
+	statistics.RequestedSize = lastRequestedSize_;
+	statistics.AllocationCount = lastAllocationCount_;
+	statistics.HighWaterMark = highWaterMark_;
+
+	for (const auto& pool : memoryPools)
+	{
+		statistics.ReservedSize += pool->GetReservedSize();
+		statistics.GrowthCount += pool->GetGrowthCount();
+		statistics.ShrinkCount += pool->GetShrinkCount();
+	}
+
+	return statistics;
+}
+
 } // namespace LLGI
@@ -11,19 +11,71 @@ class GraphicsVulkan;
 class InternalSingleFrameMemoryPoolVulkan
 {
 private:
-	int32_t constantBufferSize_ = 0;
-	int32_t constantBufferOffset_ = 0;
+	//! a buffer which is mapped persistently
+	struct Page
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		uint8_t* mapped = nullptr;
+		int32_t size = 0;
+	};
+
+	//! pages which are allocated linearly, a page is added when they are full
+	struct PageChain
+	{
+		VkBufferUsageFlags usage = 0;
+		int32_t alignment = 0;
+		int32_t initialSize = 0;
+		std::vector<Page> pages;
+		int32_t pageIndex = 0;
+		int32_t offset = 0;
+		int32_t usedSize = 0;
+		int32_t requestedSize = 0;
+		int32_t allocationCount = 0;
+	};
+
+	GraphicsVulkan* graphics_ = nullptr;
 	VkDevice nativeDevice_ = VK_NULL_HANDLE;
-	VkBuffer nativeBuffer_ = VK_NULL_HANDLE;
-	VkDeviceMemory nativeBufferMemory_ = VK_NULL_HANDLE;
+	PageChain constantBuffers_;
+	PageChain geometryBuffers_;
+	int32_t growthCount_ = 0;
+	int32_t shrinkCount_ = 0;
+
+	bool AddPage(PageChain& chain, int32_t size);
+	void DisposePages(PageChain& chain);
+	bool Allocate(PageChain& chain, int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped);
+	void Reset(PageChain& chain, bool shrink);
 
 public:
 	InternalSingleFrameMemoryPoolVulkan();
 	virtual ~InternalSingleFrameMemoryPoolVulkan();
 	bool Initialize(GraphicsVulkan* graphics, int32_t constantBufferPoolSize, int32_t drawingCount);
 	void Dispose();
-	bool GetConstantBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset);
-	void Reset();
+	bool GetConstantBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped);
+	bool GetGeometryBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped);
+
+	/**
+		@brief	start to reuse memory
+		@param	shrink	release memory which is larger than an initial size
+	*/
+	void Reset(bool shrink);
+
+	//! bytes which are used since Reset
+	int32_t GetUsedSize() const;
+
+	//! bytes which are requested since Reset, which exclude padding for alignment
+	int32_t GetRequestedSize() const;
+
+	int32_t GetAllocationCount() const;
+
+	int32_t GetReservedSize() const;
+
+	//! whether more memory than an initial size is used since Reset
+	bool GetIsGrown() const;
+
+	int32_t GetGrowthCount() const { return growthCount_; }
+
+	int32_t GetShrinkCount() const { return shrinkCount_; }
 };
 
 class SingleFrameMemoryPoolVulkan : public SingleFrameMemoryPool
@@ -35,23 +87,41 @@ private:
 	int32_t currentSwap_ = 0;
 	int32_t drawingCount_ = 0;
 
+	int64_t lastUsedSize_ = 0;
+	int64_t lastRequestedSize_ = 0;
+	int32_t lastAllocationCount_ = 0;
+	int64_t highWaterMark_ = 0;
+	int32_t quietFrameCount_ = 0;
+
 protected:
 	ConstantBuffer* CreateConstantBufferInternal(int32_t size) override;
 
 	ConstantBuffer* ReinitializeConstantBuffer(ConstantBuffer* cb, int32_t size) override;
 
+	VertexBuffer* CreateVertexBufferInternal(int32_t size) override;
+
+	VertexBuffer* ReinitializeVertexBuffer(VertexBuffer* vb, int32_t size) override;
+
+	IndexBuffer* CreateIndexBufferInternal(int32_t stride, int32_t count) override;
+
+	IndexBuffer* ReinitializeIndexBuffer(IndexBuffer* ib, int32_t stride, int32_t count) override;
+
 public:
 	SingleFrameMemoryPoolVulkan(
 		GraphicsVulkan* graphics, bool isStrongRef, int32_t swapBufferCount, int32_t constantBufferPoolSize, int32_t drawingCount);
 	~SingleFrameMemoryPoolVulkan() override;
 
-	bool GetConstantBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset);
+	bool GetConstantBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped);
+
+	bool GetGeometryBuffer(int32_t size, VkBuffer* outResource, VkDeviceMemory* deviceMemory, int32_t* outOffset, void** outMapped);
 
 	InternalSingleFrameMemoryPoolVulkan* GetInternal();
 
 	int32_t GetDrawingCount() const;
 
 	void NewFrame() override;
+
+	SingleFrameMemoryPoolStatistics GetStatistics() const override;
 };
 
 } // namespace LLGI
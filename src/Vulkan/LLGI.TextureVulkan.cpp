@@ -1,5 +1,7 @@
 
 #include "LLGI.TextureVulkan.h"
+#include "LLGI.FramebufferCacheVulkan.h"
+#include <algorithm>
 
 namespace LLGI
 {
@@ -18,6 +20,33 @@ TextureVulkan::TextureVulkan() {}
 
 TextureVulkan::~TextureVulkan()
 {
+	// an upload which was enqueued in Unlock refers the image
+	if (uploadQueueValue_ != 0)
+	{
+		graphics_->GetCommandQueue()->Wait(uploadQueueValue_);
+	}
+
+	// framebuffers must be evicted before views are destroyed
+	std::vector<std::weak_ptr<FramebufferCacheVulkan>> framebufferCaches;
+	{
+		std::lock_guard<std::mutex> lock(framebufferCachesMutex_);
+		framebufferCaches.swap(framebufferCaches_);
+	}
+
+	for (auto& cache : framebufferCaches)
+	{
+		if (auto locked = cache.lock())
+		{
+			locked->Evict(view_);
+		}
+	}
+
+	if (depthView_)
+	{
+		device_.destroyImageView(depthView_);
+		depthView_ = nullptr;
+	}
+
 	if (view_ && type_ != TextureType::Screen)
 	{
 		device_.destroyImageView(view_);
@@ -67,69 +96,81 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 		mipmapCount = 1;
 	}
 
-	cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
-
-	// image
-	vk::ImageCreateInfo imageCreateInfo;
+	// get device
+	auto device = graphics_->GetDevice();
 
-	imageCreateInfo.imageType = vk::ImageType::e2D;
-	imageCreateInfo.extent.width = size.X;
-	imageCreateInfo.extent.height = size.Y;
-	imageCreateInfo.extent.depth = 1;
-	imageCreateInfo.mipLevels = mipmapCount;
-	imageCreateInfo.arrayLayers = 1;
-	imageCreateInfo.format = format;
-	imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
-	imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
+	// calculate size
+	memorySize = GetTextureMemorySize(format_, size);
 
-	if (type_ == TextureType::Render)
+	// on unified memory, a texture which is only sampled is placed on linear memory and written without a staging copy
+	if (type_ == TextureType::Color && mipmapCount == 1 && samplingCount == 1)
 	{
-		imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst |
-								vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
-	}
-	else
-	{
-		imageCreateInfo.usage =
-			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+		isLinear_ = InitializeAsLinearImage(size, format);
 	}
 
-	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
-	imageCreateInfo.samples = (vk::SampleCountFlagBits)samplingCount_;
-	imageCreateInfo.flags = (vk::ImageCreateFlagBits)0;
+	vk::ImageLayout initialLayout = isLinear_ ? vk::ImageLayout::ePreinitialized : vk::ImageLayout::eUndefined;
 
-	image_ = graphics_->GetDevice().createImage(imageCreateInfo);
+	if (!isLinear_)
+	{
+		// image
+		vk::ImageCreateInfo imageCreateInfo;
+
+		imageCreateInfo.imageType = vk::ImageType::e2D;
+		imageCreateInfo.extent.width = size.X;
+		imageCreateInfo.extent.height = size.Y;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = mipmapCount;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.format = format;
+		imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
+		imageCreateInfo.initialLayout = initialLayout;
+
+		if (type_ == TextureType::Render)
+		{
+			imageCreateInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst |
+									vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+		}
+		else
+		{
+			imageCreateInfo.usage =
+				vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+		}
 
-	// get device
-	auto device = graphics_->GetDevice();
+		imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+		imageCreateInfo.samples = (vk::SampleCountFlagBits)samplingCount_;
+		imageCreateInfo.flags = (vk::ImageCreateFlagBits)0;
 
-	// calculate size
-	memorySize = GetTextureMemorySize(format_, size);
+		image_ = device.createImage(imageCreateInfo);
 
-	// create a buffer on cpu
-	{
-		vk::BufferCreateInfo bufferInfo;
-		bufferInfo.size = memorySize;
-		bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
-		vk::Buffer buffer = graphics_->GetDevice().createBuffer(bufferInfo);
+		// create a buffer on cpu, which is used only to write with Lock
+		if (type_ == TextureType::Color)
+		{
+			cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
 
-		vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(buffer);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
-		vk::DeviceMemory devMem = graphics_->GetDevice().allocateMemory(memAlloc);
-		graphics_->GetDevice().bindBufferMemory(buffer, devMem, 0);
+			vk::BufferCreateInfo bufferInfo;
+			bufferInfo.size = memorySize;
+			bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
+			vk::Buffer buffer = graphics_->GetDevice().createBuffer(bufferInfo);
 
-		cpuBuf->Attach(buffer, devMem);
-	}
+			vk::MemoryRequirements memReqs = graphics_->GetDevice().getBufferMemoryRequirements(buffer);
+			vk::MemoryAllocateInfo memAlloc;
+			memAlloc.allocationSize = memReqs.size;
+			memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
+			vk::DeviceMemory devMem = graphics_->GetDevice().allocateMemory(memAlloc);
+			graphics_->GetDevice().bindBufferMemory(buffer, devMem, 0);
 
-	// create a buffer on gpu
-	{
-		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image_);
-		vk::MemoryAllocateInfo memAlloc;
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-		devMem_ = device.allocateMemory(memAlloc);
-		graphics_->GetDevice().bindImageMemory(image_, devMem_, 0);
+			cpuBuf->Attach(buffer, devMem);
+		}
+
+		// create a buffer on gpu
+		{
+			vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image_);
+			vk::MemoryAllocateInfo memAlloc;
+			memAlloc.allocationSize = memReqs.size;
+			memAlloc.memoryTypeIndex = graphics_->GetMemoryTypeIndex(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+			devMem_ = device.allocateMemory(memAlloc);
+			graphics_->GetDevice().bindImageMemory(image_, devMem_, 0);
+		}
 	}
 
 	// create a texture view
@@ -149,12 +190,88 @@ bool TextureVulkan::Initialize(GraphicsVulkan* graphics,
 
 	textureSize = size;
 	mipmapCount_ = mipmapCount;
-	vkTextureFormat_ = imageCreateInfo.format;
+	vkTextureFormat_ = format;
 	format_ = VulkanHelper::VkFormatToTextureFormat(static_cast<VkFormat>(vkTextureFormat_));
 	device_ = graphics_->GetDevice();
 
-	ResetImageLayouts(mipmapCount_, imageCreateInfo.initialLayout);
+	ResetImageLayouts(mipmapCount_, initialLayout);
+
+	return true;
+}
+
+bool TextureVulkan::InitializeAsLinearImage(const Vec2I& size, vk::Format format)
+{
+	if (!graphics_->GetIsUnifiedMemory())
+	{
+		return false;
+	}
+
+	auto properties = graphics_->GetPysicalDevice().getFormatProperties(format);
+	if (!(properties.linearTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage))
+	{
+		return false;
+	}
+
+	const auto usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+
+	VkImageFormatProperties imageFormatProperties;
+	if (vkGetPhysicalDeviceImageFormatProperties(static_cast<VkPhysicalDevice>(graphics_->GetPysicalDevice()),
+												 static_cast<VkFormat>(format),
+												 VK_IMAGE_TYPE_2D,
+												 VK_IMAGE_TILING_LINEAR,
+												 static_cast<VkImageUsageFlags>(usage),
+												 0,
+												 &imageFormatProperties) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	if (imageFormatProperties.maxExtent.width < static_cast<uint32_t>(size.X) ||
+		imageFormatProperties.maxExtent.height < static_cast<uint32_t>(size.Y))
+	{
+		return false;
+	}
+
+	auto device = graphics_->GetDevice();
+
+	vk::ImageCreateInfo imageCreateInfo;
+	imageCreateInfo.imageType = vk::ImageType::e2D;
+	imageCreateInfo.extent = vk::Extent3D(size.X, size.Y, 1);
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.format = format;
+	imageCreateInfo.tiling = vk::ImageTiling::eLinear;
+	imageCreateInfo.initialLayout = vk::ImageLayout::ePreinitialized;
+	imageCreateInfo.usage = usage;
+	imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+	imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
+	auto image = device.createImage(imageCreateInfo);
+
+	// Lock returns a pointer to tightly packed pixels, so rows must not be padded
+	vk::ImageSubresource subresource(vk::ImageAspectFlagBits::eColor, 0, 0);
+	auto layout = device.getImageSubresourceLayout(image, subresource);
+	auto rowSize = static_cast<vk::DeviceSize>(GetTextureMemorySize(format_, Vec2I(size.X, 1)));
+
+	vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(image);
+	uint32_t memoryTypeIndex = 0;
+
+	if (layout.offset != 0 || layout.rowPitch != rowSize ||
+		!graphics_->TryGetMemoryTypeIndex(memReqs.memoryTypeBits,
+										  vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible |
+											  vk::MemoryPropertyFlagBits::eHostCoherent,
+										  memoryTypeIndex))
+	{
+		device.destroyImage(image);
+		return false;
+	}
 
+	vk::MemoryAllocateInfo memAlloc;
+	memAlloc.allocationSize = memReqs.size;
+	memAlloc.memoryTypeIndex = memoryTypeIndex;
+	devMem_ = device.allocateMemory(memAlloc);
+	device.bindImageMemory(image, devMem_, 0);
+
+	image_ = image;
 	return true;
 }
 
@@ -232,7 +349,15 @@ bool TextureVulkan::InitializeAsDepthStencil(
 	imageCreateInfo.mipLevels = 1;
 	imageCreateInfo.arrayLayers = 1;
 	imageCreateInfo.samples = (vk::SampleCountFlagBits)samplingCount_;
-	imageCreateInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment /* | vk::ImageUsageFlagBits::eSampled*/;
+	imageCreateInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+
+	// a depth texture can be sampled after a render pass like a shadow map
+	const auto isSampled = static_cast<bool>(formatProps.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage);
+	if (isSampled)
+	{
+		imageCreateInfo.usage |= vk::ImageUsageFlagBits::eSampled;
+	}
+
 	image_ = device.createImage(imageCreateInfo);
 
 	// allocate memory
@@ -257,6 +382,13 @@ bool TextureVulkan::InitializeAsDepthStencil(
 	subresourceRange_ = viewCreateInfo.subresourceRange;
 	vkTextureFormat_ = depthFormat;
 
+	// a sampled view must have only one aspect
+	if (isSampled && HasStencil(format_))
+	{
+		viewCreateInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
+		depthView_ = device.createImageView(viewCreateInfo);
+	}
+
 	mipmapCount_ = 1;
 	ResetImageLayouts(mipmapCount_, imageCreateInfo.initialLayout);
 
@@ -302,6 +434,37 @@ void* TextureVulkan::Lock()
 	if (graphics_ == nullptr)
 		return nullptr;
 
+	// a linear image is written directly until gpu uses it, because cpu can write it only in preinitialized or general layout
+	// after that, it is copied from a staging buffer on gpu so that previous frames which sample it are not changed
+	isLockedInPlace_ = isLinear_ && imageLayouts_[0] == vk::ImageLayout::ePreinitialized;
+	if (isLockedInPlace_)
+	{
+		data = graphics_->GetDevice().mapMemory(devMem_, 0, memorySize, vk::MemoryMapFlags());
+		return data;
+	}
+
+	if (cpuBuf == nullptr && isLinear_)
+	{
+		cpuBuf = std::unique_ptr<Buffer>(new Buffer(graphics_));
+		if (!CreateMappableBuffer(graphics_, memorySize, vk::BufferUsageFlagBits::eTransferSrc, *cpuBuf))
+		{
+			cpuBuf.reset();
+		}
+	}
+
+	if (cpuBuf == nullptr)
+	{
+		Log(LogType::Error, "TextureVulkan::Lock : a render texture cannot be locked.");
+		return nullptr;
+	}
+
+	// a staging buffer may be read by a previous copy
+	if (uploadQueueValue_ != 0)
+	{
+		graphics_->GetCommandQueue()->Wait(uploadQueueValue_);
+		uploadQueueValue_ = 0;
+	}
+
 	data = graphics_->GetDevice().mapMemory(cpuBuf->devMem(), 0, memorySize, vk::MemoryMapFlags());
 	return data;
 }
@@ -313,18 +476,27 @@ void TextureVulkan::Unlock()
 		return;
 	}
 
-	graphics_->GetDevice().unmapMemory(cpuBuf->devMem());
+	if (isLockedInPlace_)
+	{
+		// written data is visible for gpu with the submission, so only a layout is changed
+		isLockedInPlace_ = false;
+		graphics_->GetDevice().unmapMemory(devMem_);
 
-	// copy buffer
-	vk::CommandBufferAllocateInfo cmdBufInfo;
-	cmdBufInfo.commandPool = graphics_->GetCommandPool();
-	cmdBufInfo.level = vk::CommandBufferLevel::ePrimary;
-	cmdBufInfo.commandBufferCount = 1;
-	vk::CommandBuffer copyCommandBuffer = graphics_->GetDevice().allocateCommandBuffers(cmdBufInfo)[0];
+		vk::CommandBuffer commandBuffer = static_cast<vk::CommandBuffer>(graphics_->BeginSingleTimeCommands());
+		ResourceBarrior(commandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
+		uploadQueueValue_ = graphics_->EnqueueSingleTimeCommands(static_cast<VkCommandBuffer>(commandBuffer));
+		return;
+	}
 
-	vk::CommandBufferBeginInfo cmdBufferBeginInfo;
+	if (cpuBuf == nullptr)
+	{
+		return;
+	}
+
+	graphics_->GetDevice().unmapMemory(cpuBuf->devMem());
 
-	copyCommandBuffer.begin(cmdBufferBeginInfo);
+	// a copy is ordered after commands which were executed before, so they read previous data
+	vk::CommandBuffer copyCommandBuffer = static_cast<vk::CommandBuffer>(graphics_->BeginSingleTimeCommands());
 
 	vk::BufferImageCopy imageBufferCopy;
 
@@ -340,26 +512,12 @@ void TextureVulkan::Unlock()
 	imageBufferCopy.imageOffset = vk::Offset3D(0, 0, 0);
 	imageBufferCopy.imageExtent = vk::Extent3D(static_cast<uint32_t>(GetSizeAs2D().X), static_cast<uint32_t>(GetSizeAs2D().Y), 1);
 
-	vk::ImageSubresourceRange colorSubRange;
-	colorSubRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	colorSubRange.levelCount = 1;
-	colorSubRange.layerCount = 1;
-
 	vk::ImageLayout imageLayout = vk::ImageLayout::eTransferDstOptimal;
 	ResourceBarrior(copyCommandBuffer, imageLayout);
 	copyCommandBuffer.copyBufferToImage(cpuBuf->buffer(), image_, imageLayout, imageBufferCopy);
 	ResourceBarrior(copyCommandBuffer, vk::ImageLayout::eShaderReadOnlyOptimal);
-	copyCommandBuffer.end();
 
-	// submit and wait to execute command
-	std::array<vk::SubmitInfo, 1> copySubmitInfos;
-	copySubmitInfos[0].commandBufferCount = 1;
-	copySubmitInfos[0].pCommandBuffers = &copyCommandBuffer;
-
-	graphics_->GetQueue().submit(static_cast<uint32_t>(copySubmitInfos.size()), copySubmitInfos.data(), vk::Fence());
-	graphics_->GetQueue().waitIdle();
-
-	graphics_->GetDevice().freeCommandBuffers(graphics_->GetCommandPool(), copyCommandBuffer);
+	uploadQueueValue_ = graphics_->EnqueueSingleTimeCommands(static_cast<VkCommandBuffer>(copyCommandBuffer));
 }
 
 Vec2I TextureVulkan::GetSizeAs2D() const { return textureSize; }
@@ -378,13 +536,48 @@ void TextureVulkan::ChangeImageLayout(int32_t mipLevel, const vk::ImageLayout& i
 
 void TextureVulkan::ResourceBarrior(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
 {
-	for (int32_t i = 0; i < mipmapCount_; i++)
+	BarrierBatcherVulkan batcher;
+	ResourceBarrior(batcher, imageLayout);
+	batcher.Flush(commandBuffer);
+}
+
+void TextureVulkan::ResourceBarrior(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+{
+	BarrierBatcherVulkan batcher;
+	ResourceBarrior(mipLevel, batcher, imageLayout);
+	batcher.Flush(commandBuffer);
+}
+
+void TextureVulkan::ResourceBarrior(BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout, bool isDiscarded)
+{
+	int32_t begin = 0;
+	while (begin < mipmapCount_)
 	{
-		ResourceBarrior(i, commandBuffer, imageLayout);
+		int32_t end = begin + 1;
+		while (end < mipmapCount_ && imageLayouts_[end] == imageLayouts_[begin])
+		{
+			end++;
+		}
+
+		// a discarded image is transitioned even if a layout is same to wait for previous commands
+		if (imageLayouts_[begin] != imageLayout || isDiscarded)
+		{
+			auto subresourceRange = subresourceRange_;
+			subresourceRange.baseMipLevel = begin;
+			subresourceRange.levelCount = end - begin;
+			batcher.AddImageBarrier(image_, subresourceRange, imageLayouts_[begin], imageLayout, isDiscarded);
+
+			for (int32_t i = begin; i < end; i++)
+			{
+				ChangeImageLayout(i, imageLayout);
+			}
+		}
+
+		begin = end;
 	}
 }
 
-void TextureVulkan::ResourceBarrior(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout)
+void TextureVulkan::ResourceBarrior(int32_t mipLevel, BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout)
 {
 	if (imageLayouts_[mipLevel] == imageLayout)
 	{
@@ -394,8 +587,29 @@ void TextureVulkan::ResourceBarrior(int32_t mipLevel, vk::CommandBuffer& command
 	auto subresourceRange = subresourceRange_;
 	subresourceRange.baseMipLevel = mipLevel;
 	subresourceRange.levelCount = 1;
-	SetImageLayout(commandBuffer, image_, imageLayouts_[mipLevel], imageLayout, subresourceRange);
+	batcher.AddImageBarrier(image_, subresourceRange, imageLayouts_[mipLevel], imageLayout);
 	ChangeImageLayout(mipLevel, imageLayout);
 }
 
+void TextureVulkan::AddFramebufferCache(const std::shared_ptr<FramebufferCacheVulkan>& cache)
+{
+	std::lock_guard<std::mutex> lock(framebufferCachesMutex_);
+
+	for (auto& registered : framebufferCaches_)
+	{
+		if (registered.lock() == cache)
+		{
+			return;
+		}
+	}
+
+	// expired caches are removed
+	framebufferCaches_.erase(std::remove_if(framebufferCaches_.begin(),
+											framebufferCaches_.end(),
+											[](const std::weak_ptr<FramebufferCacheVulkan>& c) { return c.expired(); }),
+							 framebufferCaches_.end());
+
+	framebufferCaches_.push_back(cache);
+}
+
 } // namespace LLGI
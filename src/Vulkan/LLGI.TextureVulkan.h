@@ -4,6 +4,8 @@
 #include "../LLGI.Texture.h"
 #include "LLGI.BaseVulkan.h"
 #include "LLGI.GraphicsVulkan.h"
+#include <atomic>
+#include <mutex>
 
 namespace LLGI
 {
@@ -19,6 +21,9 @@ private:
 	bool isStrongRef_ = false;
 	vk::Image image_ = nullptr;
 	vk::ImageView view_ = nullptr;
+
+	//! a view which has only a depth aspect to be sampled, it is created if a depth texture has stencil
+	vk::ImageView depthView_ = nullptr;
 	std::vector<vk::ImageLayout> imageLayouts_;
 	vk::DeviceMemory devMem_ = nullptr;
 	vk::Format vkTextureFormat_;
@@ -32,8 +37,26 @@ private:
 
 	bool isExternalResource_ = false;
 
+	//! whether the image is placed on linear memory which is written directly
+	bool isLinear_ = false;
+
+	//! whether data in Lock is written into the image directly instead of cpuBuf
+	bool isLockedInPlace_ = false;
+
+	//! a value of a command queue which is completed when gpu finishes commands which were enqueued in Unlock
+	uint64_t uploadQueueValue_ = 0;
+
+	//! caches which have framebuffers with this texture, they may be added from render passes in any thread
+	std::vector<std::weak_ptr<FramebufferCacheVulkan>> framebufferCaches_;
+	std::mutex framebufferCachesMutex_;
+
+	//! a value of a command queue which is completed when gpu finishes commands using this texture, it is read in other threads
+	std::atomic<uint64_t> usedQueueValue_{0};
+
 	void ResetImageLayouts(int32_t count, vk::ImageLayout layout);
 
+	bool InitializeAsLinearImage(const Vec2I& size, vk::Format format);
+
 public:
 	TextureVulkan();
 	~TextureVulkan() override;
@@ -69,6 +92,9 @@ public:
 	const vk::Image& GetImage() const { return image_; }
 	const vk::ImageView& GetView() const { return view_; }
 
+	//! a view which is bound to shaders
+	const vk::ImageView& GetSampledView() const { return depthView_ ? depthView_ : view_; }
+
 	vk::Format GetVulkanFormat() const { return vkTextureFormat_; }
 	int32_t GetMemorySize() const { return memorySize; }
 
@@ -83,6 +109,23 @@ public:
 	void ResourceBarrior(vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout);
 
 	void ResourceBarrior(int32_t mipLevel, vk::CommandBuffer& commandBuffer, const vk::ImageLayout& imageLayout);
+
+	/**
+		@brief	add transitions to a batcher instead of recording them
+		@note
+		Contiguous mip levels in a same layout are transitioned with one subresource range.
+	*/
+	void ResourceBarrior(BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout, bool isDiscarded = false);
+
+	void ResourceBarrior(int32_t mipLevel, BarrierBatcherVulkan& batcher, const vk::ImageLayout& imageLayout);
+
+	//! framebuffers with this texture are evicted from the cache when this texture is destroyed
+	void AddFramebufferCache(const std::shared_ptr<FramebufferCacheVulkan>& cache);
+
+	//! it is set when commands using this texture are executed, 0 if they are not executed with a command queue
+	uint64_t GetUsedQueueValue() const { return usedQueueValue_.load(); }
+
+	void SetUsedQueueValue(uint64_t value) { usedQueueValue_.store(value); }
 };
 
 } // namespace LLGI
@@ -0,0 +1,169 @@
+#include "LLGI.TransientRenderTexturePoolVulkan.h"
+#include "LLGI.CommandQueueVulkan.h"
+#include "LLGI.GraphicsVulkan.h"
+#include "LLGI.TextureVulkan.h"
+#include <iterator>
+
+namespace LLGI
+{
+
+TransientRenderTexturePoolVulkan::TransientRenderTexturePoolVulkan(GraphicsVulkan* graphics) : graphics_(graphics) {}
+
+TransientRenderTexturePoolVulkan::~TransientRenderTexturePoolVulkan()
+{
+	// GraphicsVulkan waits for gpu before it is disposed
+	for (auto& entry : usedEntries_)
+	{
+		SafeRelease(entry.texture);
+	}
+	usedEntries_.clear();
+
+	for (auto& entry : freeEntries_)
+	{
+		SafeRelease(entry.texture);
+	}
+	freeEntries_.clear();
+}
+
+bool TransientRenderTexturePoolVulkan::GetIsMatched(const RenderTextureInitializationParameter& a,
+													const RenderTextureInitializationParameter& b)
+{
+	return a.Size == b.Size && a.Format == b.Format && a.SamplingCount == b.SamplingCount;
+}
+
+void TransientRenderTexturePoolVulkan::Collect(const GPUTimeStampVulkan& now)
+{
+	auto commandQueue = graphics_->GetCommandQueue();
+
+	// used entries are sorted by time, so free entries are kept sorted from the least recently used one
+	for (size_t i = 0; i < usedEntries_.size();)
+	{
+		const auto& timeStamp = usedEntries_[i].timeStamp;
+
+		// a texture is available until the frame in which it was acquired ends even if gpu finishes commands in the frame
+		const auto isFrameEnded = timeStamp.PresentedFrameCount < now.PresentedFrameCount ||
+								  timeStamp.WaitFinishCount < now.WaitFinishCount || usedEntries_[i].frameCount < frameCount_;
+
+		bool isAvailable = isFrameEnded && graphics_->GetIsCompleted(timeStamp);
+		if (isAvailable && commandQueue != nullptr && timeStamp.QueueValue > 0)
+		{
+			// commands which were executed later with the texture are also waited for
+			const auto usedValue = static_cast<TextureVulkan*>(usedEntries_[i].texture)->GetUsedQueueValue();
+			isAvailable = usedValue == 0 || commandQueue->IsCompleted(usedValue);
+		}
+
+		if (isAvailable)
+		{
+			freeEntries_.push_back(usedEntries_[i]);
+			usedEntries_.erase(usedEntries_.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void TransientRenderTexturePoolVulkan::Trim(const GPUTimeStampVulkan& now)
+{
+	const auto frameCount = graphics_->GetTransientRenderTextureTrimFrameCount();
+	if (frameCount <= 0)
+	{
+		return;
+	}
+
+	// frames are counted by completed values of a command queue if it exists, so that textures are trimmed without presenting
+	auto commandQueue = graphics_->GetCommandQueue();
+	const auto isCountedByQueue = commandQueue != nullptr;
+	const auto completedValue = isCountedByQueue ? commandQueue->GetCompletedValue() : 0;
+
+	auto it = freeEntries_.begin();
+	while (it != freeEntries_.end())
+	{
+		const auto isExpired = isCountedByQueue ? it->timeStamp.QueueValue + frameCount <= completedValue
+												: it->timeStamp.PresentedFrameCount + frameCount <= now.PresentedFrameCount;
+		if (!isExpired)
+		{
+			break;
+		}
+
+		SafeRelease(it->texture);
+		statistics_.TrimCount++;
+		++it;
+	}
+
+	freeEntries_.erase(freeEntries_.begin(), it);
+}
+
+Texture* TransientRenderTexturePoolVulkan::Acquire(const RenderTextureInitializationParameter& parameter)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const auto now = graphics_->GetTimeStamp();
+	Collect(now);
+	Trim(now);
+
+	statistics_.AcquireCount++;
+
+	// the most recently used texture is reused to keep others trimmed
+	for (auto it = freeEntries_.rbegin(); it != freeEntries_.rend(); ++it)
+	{
+		if (!GetIsMatched(it->parameter, parameter))
+		{
+			continue;
+		}
+
+		auto entry = *it;
+		freeEntries_.erase(std::next(it).base());
+
+		entry.timeStamp = now;
+		entry.frameCount = frameCount_;
+		usedEntries_.push_back(entry);
+		statistics_.ReuseCount++;
+		return entry.texture;
+	}
+
+	Entry entry;
+	entry.texture = graphics_->CreateRenderTexture(parameter);
+	if (entry.texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	entry.parameter = parameter;
+	entry.memorySize = static_cast<int64_t>(GetTextureMemorySize(parameter.Format, parameter.Size)) * parameter.SamplingCount;
+	entry.timeStamp = now;
+	entry.frameCount = frameCount_;
+	usedEntries_.push_back(entry);
+	return entry.texture;
+}
+
+void TransientRenderTexturePoolVulkan::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	frameCount_++;
+}
+
+TransientRenderTexturePoolStatistics TransientRenderTexturePoolVulkan::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto statistics = statistics_;
+	statistics.TextureCount = static_cast<int32_t>(usedEntries_.size() + freeEntries_.size());
+	statistics.UsedTextureCount = static_cast<int32_t>(usedEntries_.size());
+	statistics.MemorySize = 0;
+
+	for (const auto& entry : usedEntries_)
+	{
+		statistics.MemorySize += entry.memorySize;
+	}
+
+	for (const auto& entry : freeEntries_)
+	{
+		statistics.MemorySize += entry.memorySize;
+	}
+
+	return statistics;
+}
+
+} // namespace LLGI
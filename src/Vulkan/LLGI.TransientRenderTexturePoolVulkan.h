@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../LLGI.Graphics.h"
+#include "LLGI.BaseVulkan.h"
+#include <mutex>
+
+namespace LLGI
+{
+
+/**
+	@brief	a pool of render textures which are used only in a frame
+	@note
+	A texture returns to a free list after gpu finishes a frame in which it was acquired,
+	and a free texture is reused by an acquisition with the same size, format and sampling count.
+	Free textures which are not acquired in some frames are released from the least recently used one.
+	A frame ends by presenting, Graphics::WaitFinish or Graphics::EndTransientRenderTextureFrame, so that it works without presenting.
+	With a command queue, textures are also kept until commands which were executed later with them are finished.
+*/
+class TransientRenderTexturePoolVulkan
+{
+private:
+	struct Entry
+	{
+		Texture* texture = nullptr;
+		RenderTextureInitializationParameter parameter;
+		int64_t memorySize = 0;
+
+		//! when the texture was acquired last
+		GPUTimeStampVulkan timeStamp;
+
+		//! frames which were ended explicitly when the texture was acquired last
+		uint64_t frameCount = 0;
+	};
+
+	//! it is not referenced because it owns this pool
+	GraphicsVulkan* graphics_ = nullptr;
+
+	std::mutex mutex_;
+	std::vector<Entry> usedEntries_;
+
+	//! sorted from the least recently used one
+	std::vector<Entry> freeEntries_;
+
+	uint64_t frameCount_ = 0;
+
+	TransientRenderTexturePoolStatistics statistics_;
+
+	static bool GetIsMatched(const RenderTextureInitializationParameter& a, const RenderTextureInitializationParameter& b);
+
+	void Collect(const GPUTimeStampVulkan& now);
+
+	void Trim(const GPUTimeStampVulkan& now);
+
+public:
+	TransientRenderTexturePoolVulkan(GraphicsVulkan* graphics);
+	~TransientRenderTexturePoolVulkan();
+
+	TransientRenderTexturePoolVulkan(const TransientRenderTexturePoolVulkan&) = delete;
+	TransientRenderTexturePoolVulkan& operator=(const TransientRenderTexturePoolVulkan&) = delete;
+
+	Texture* Acquire(const RenderTextureInitializationParameter& parameter);
+
+	void EndFrame();
+
+	TransientRenderTexturePoolStatistics GetStatistics();
+};
+
+} // namespace LLGI
@@ -18,19 +18,34 @@ private:
 	void* data = nullptr;
 	int32_t memSize = 0;
 
+	//! an offset in gpuBuf and a persistently mapped pointer if it is allocated from a memory pool
+	int32_t offset_ = 0;
+	void* mappedData_ = nullptr;
+
+	//! previous buffers which were replaced by Lock(LockMode::Discard) or by an in-place write while gpu reads them
+	DiscardedBuffersVulkan discardedBuffers_;
+
+	//! replace a buffer on unified memory with a copy if gpu may read it, so that it is written in place safely
+	void RenameIfUsed();
+
 public:
 	bool Initialize(GraphicsVulkan* graphics, int32_t size);
-	bool InitializeAsShortTime(SingleFrameMemoryPoolVulkan* memoryPool, int32_t size);
+	bool InitializeAsShortTime(GraphicsVulkan* graphics, SingleFrameMemoryPoolVulkan* memoryPool, int32_t size);
 
 	VertexBufferVulkan();
 	~VertexBufferVulkan() override;
 
 	void* Lock() override;
 	void* Lock(int32_t offset, int32_t size) override;
+	void* Lock(LockMode mode) override;
 	void Unlock() override;
 	int32_t GetSize() override;
 
 	vk::Buffer GetBuffer() { return gpuBuf->buffer(); }
+	int32_t GetOffset() const { return offset_; }
+
+	//! a buffer which is bound now, it is replaced by renaming
+	Buffer* GetCurrentBuffer() { return gpuBuf.get(); }
 };
 
 } // namespace LLGI
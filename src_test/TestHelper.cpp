@@ -302,6 +302,109 @@ void TestHelper::CreateShader(LLGI::Graphics* graphics,
 	}
 }
 
+std::shared_ptr<LLGI::PipelineState> TestHelper::CreatePipelineState(
+	LLGI::Graphics* graphics, LLGI::RenderPass* renderPass, LLGI::Shader* vs, LLGI::Shader* ps, bool isDepthEnabled)
+{
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+	auto pip = LLGI::CreateSharedPtr(graphics->CreatePiplineState());
+	pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+	pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+	pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+	pip->VertexLayoutNames[0] = "POSITION";
+	pip->VertexLayoutNames[1] = "UV";
+	pip->VertexLayoutNames[2] = "COLOR";
+	pip->VertexLayoutCount = 3;
+	pip->IsDepthTestEnabled = isDepthEnabled;
+	pip->IsDepthWriteEnabled = isDepthEnabled;
+	pip->SetShader(LLGI::ShaderStageType::Vertex, vs);
+	pip->SetShader(LLGI::ShaderStageType::Pixel, ps);
+	pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+	pip->Compile();
+	return pip;
+}
+
+std::vector<LLGI::Color8>
+TestHelper::ReadPixels(LLGI::Graphics* graphics, LLGI::Texture* texture, const std::vector<LLGI::Vec2I>& positions)
+{
+	graphics->WaitFinish();
+
+	// pixels are packed without padding
+	auto data = graphics->CaptureRenderTarget(texture);
+	const auto size = texture->GetSizeAs2D();
+	if (data.size() < static_cast<size_t>(size.X * size.Y * 4))
+	{
+		return std::vector<LLGI::Color8>();
+	}
+
+	std::vector<LLGI::Color8> colors;
+	for (const auto& position : positions)
+	{
+		auto pixel = data.data() + (position.Y * size.X + position.X) * 4;
+		colors.push_back(LLGI::Color8(pixel[0], pixel[1], pixel[2], pixel[3]));
+	}
+
+	return colors;
+}
+
+TestContext::TestContext(const char* title, const LLGI::PlatformParameter& pp)
+{
+	Window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow(title, LLGI::Vec2I(1280, 720)));
+	Platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, Window.get()));
+	Graphics = LLGI::CreateSharedPtr(Platform->CreateGraphics());
+	MemoryPool = LLGI::CreateSharedPtr(Graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+
+	for (auto& commandList : CommandLists)
+	{
+		commandList = LLGI::CreateSharedPtr(Graphics->CreateCommandList(MemoryPool.get()));
+	}
+}
+
+TestContext::TestContext(const char* title, LLGI::DeviceType deviceType)
+	: TestContext(title,
+				  [deviceType]() -> LLGI::PlatformParameter {
+					  LLGI::PlatformParameter pp;
+					  pp.Device = deviceType;
+					  pp.WaitVSync = true;
+					  return pp;
+				  }())
+{
+}
+
+TestContext::~TestContext()
+{
+	if (Graphics != nullptr)
+	{
+		Graphics->WaitFinish();
+	}
+}
+
+bool TestContext::NewFrame()
+{
+	if (!Platform->NewFrame())
+	{
+		return false;
+	}
+
+	MemoryPool->NewFrame();
+	return true;
+}
+
+LLGI::CommandList* TestContext::BeginCommandList(int32_t frame)
+{
+	auto commandList = CommandLists[frame % CommandLists.size()].get();
+	commandList->WaitUntilCompleted();
+	commandList->Begin();
+	return commandList;
+}
+
+void TestContext::Present(LLGI::CommandList* commandList)
+{
+	commandList->End();
+	Graphics->Execute(commandList);
+	Platform->Present();
+}
+
 void TestHelper::Run(const ParsedArgs& args)
 {
 	auto helper = Get();
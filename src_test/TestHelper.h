@@ -1,6 +1,7 @@
 
 #pragma once
 #include "test.h"
+#include <array>
 #include <functional>
 #include <map>
 #include <memory>
@@ -54,6 +55,19 @@ public:
 							 std::shared_ptr<LLGI::Shader>& vs,
 							 std::shared_ptr<LLGI::Shader>& ps);
 
+	/**
+		@brief create a pipeline state for vertices which are created by CreateRectangle
+	*/
+	static std::shared_ptr<LLGI::PipelineState> CreatePipelineState(
+		LLGI::Graphics* graphics, LLGI::RenderPass* renderPass, LLGI::Shader* vs, LLGI::Shader* ps, bool isDepthEnabled = false);
+
+	/**
+		@brief read pixels of a render texture after gpu finishes all commands
+		@return	colors at positions, empty if the texture cannot be read
+	*/
+	static std::vector<LLGI::Color8>
+	ReadPixels(LLGI::Graphics* graphics, LLGI::Texture* texture, const std::vector<LLGI::Vec2I>& positions);
+
 	static void Run(const ParsedArgs& args);
 
 	static void RegisterTest(const char* name, std::function<void(LLGI::DeviceType)> func);
@@ -63,6 +77,34 @@ public:
 	static void Dispose();
 };
 
+/**
+	@brief a window, a platform, a graphics and command lists which tests render frames with
+	@note
+	gpu is waited before they are released.
+*/
+class TestContext
+{
+public:
+	std::unique_ptr<LLGI::Window> Window;
+	std::shared_ptr<LLGI::Platform> Platform;
+	std::shared_ptr<LLGI::Graphics> Graphics;
+	std::shared_ptr<LLGI::SingleFrameMemoryPool> MemoryPool;
+	std::array<std::shared_ptr<LLGI::CommandList>, 3> CommandLists;
+
+	TestContext(const char* title, const LLGI::PlatformParameter& pp);
+	TestContext(const char* title, LLGI::DeviceType deviceType);
+	~TestContext();
+
+	//! start a frame, it fails if a window is closed
+	bool NewFrame();
+
+	//! begin a command list of a frame after gpu finishes it
+	LLGI::CommandList* BeginCommandList(int32_t frame);
+
+	//! end and execute a command list, and present a frame
+	void Present(LLGI::CommandList* commandList);
+};
+
 struct TestRegister
 {
 	TestRegister(const char* name, std::function<void(LLGI::DeviceType)> func) { TestHelper::RegisterTest(name, func); }
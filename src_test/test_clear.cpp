@@ -132,6 +132,324 @@ void test_clear(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(platform);
 }
 
+void test_clear_multiple_command_lists(LLGI::DeviceType deviceType, bool useSubmissionThread)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	pp.UseSubmissionThread = useSubmissionThread;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("ClearMultipleCommandLists", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	// many command lists are executed in a frame and submitted together
+	std::array<LLGI::CommandList*, 8> commandLists;
+	for (size_t i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		for (size_t i = 0; i < commandLists.size(); i++)
+		{
+			LLGI::Color8 color;
+			color.R = static_cast<uint8_t>((count + i * 16) % 255);
+			color.G = static_cast<uint8_t>(i * 32);
+			color.B = 0;
+			color.A = 255;
+
+			auto commandList = commandLists[i];
+			commandList->Begin();
+			commandList->BeginRenderPass(platform->GetCurrentScreen(color, true, false));
+			commandList->EndRenderPass();
+			commandList->End();
+
+			graphics->Execute(commandList);
+
+			// submit a part of commands explicitly
+			if (i == commandLists.size() / 2)
+			{
+				graphics->Flush();
+			}
+		}
+
+		platform->Present();
+		count++;
+
+		if (count == 30)
+		{
+			// each command list can be waited after commands were submitted together
+			commandLists[0]->WaitUntilCompleted();
+			commandLists.back()->WaitUntilCompleted();
+
+			if (TestHelper::GetIsCaptureRequired())
+			{
+				auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
+				auto data = graphics->CaptureRenderTarget(texture);
+				Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat())
+					.Save(useSubmissionThread ? "Clear.SubmissionThread.png" : "Clear.MultipleCommandLists.png");
+			}
+		}
+	}
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (size_t i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_clear_sync_point(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("ClearSyncPoint", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (size_t i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	LLGI::SyncPoint lastSyncPoint;
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		LLGI::Color8 color;
+		color.R = 0;
+		color.G = (count + 100) % 255;
+		color.B = 0;
+		color.A = 255;
+
+		// commands in this frame start after commands in a previous frame are finished
+		graphics->WaitOnGPU(lastSyncPoint);
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->Begin();
+		commandList->BeginRenderPass(platform->GetCurrentScreen(color, true, false));
+		commandList->EndRenderPass();
+		commandList->End();
+
+		auto syncPoint = graphics->Execute(commandList);
+
+		if (syncPoint.IsValid() && lastSyncPoint.IsValid() && syncPoint.Value < lastSyncPoint.Value)
+		{
+			std::cout << "Failed : a sync point is decreased." << std::endl;
+			abort();
+		}
+
+		lastSyncPoint = syncPoint;
+
+		platform->Present();
+		count++;
+
+		if (count == 30)
+		{
+			if (!graphics->Wait(syncPoint) || !graphics->IsCompleted(syncPoint))
+			{
+				std::cout << "Failed : a sync point is not completed after waiting." << std::endl;
+				abort();
+			}
+		}
+	}
+
+	graphics->WaitFinish();
+
+	if (!graphics->IsCompleted(lastSyncPoint))
+	{
+		std::cout << "Failed : a sync point is not completed after WaitFinish." << std::endl;
+		abort();
+	}
+
+	LLGI::SafeRelease(sfMemoryPool);
+	for (size_t i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_clear_frame_count(LLGI::DeviceType deviceType, int32_t frameCount)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	pp.FrameCount = frameCount;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("ClearFrameCount", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	// frames in flight do not depend on the number of swap buffers
+	if (platform->GetDeviceType() == LLGI::DeviceType::Vulkan && platform->GetMaxFrameCount() != frameCount)
+	{
+		std::cout << "Failed : GetMaxFrameCount returned " << platform->GetMaxFrameCount() << std::endl;
+		abort();
+	}
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+	auto commandList = graphics->CreateCommandList(sfMemoryPool);
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		// memory in a pool is reused after frames in flight
+		auto cb = sfMemoryPool->CreateConstantBuffer(sizeof(float) * 4);
+		auto data = static_cast<float*>(cb->Lock());
+		data[0] = static_cast<float>(count);
+		cb->Unlock();
+		LLGI::SafeRelease(cb);
+
+		LLGI::Color8 color;
+		color.R = 0;
+		color.G = 0;
+		color.B = (count + 100) % 255;
+		color.A = 255;
+
+		commandList->Begin();
+		commandList->BeginRenderPass(platform->GetCurrentScreen(color, true, false));
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+	}
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_clear_continue(LLGI::DeviceType deviceType, bool isFlushed)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("ClearContinue", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+	auto commandList = graphics->CreateCommandList(sfMemoryPool);
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		commandList->Begin();
+
+		// a frame is split into chunks which are submitted while later chunks are recorded
+		for (int32_t i = 0; i < 4; i++)
+		{
+			if (i > 0 && !commandList->Continue())
+			{
+				// chunks can be continued even if executed commands are not flushed yet
+				if (platform->GetDeviceType() == LLGI::DeviceType::Vulkan)
+				{
+					std::cout << "Failed : Continue failed after Execute." << std::endl;
+					abort();
+				}
+
+				if (count == 0)
+				{
+					std::cout << "Skip : Continue is not supported." << std::endl;
+				}
+				break;
+			}
+
+			LLGI::Color8 color;
+			color.R = static_cast<uint8_t>(i * 64);
+			color.G = (count + 100) % 255;
+			color.B = 0;
+			color.A = 255;
+
+			commandList->BeginRenderPass(platform->GetCurrentScreen(color, true, false));
+			commandList->EndRenderPass();
+			commandList->End();
+
+			graphics->Execute(commandList);
+
+			if (isFlushed)
+			{
+				graphics->Flush();
+			}
+		}
+
+		platform->Present();
+		count++;
+
+		if (count == 30)
+		{
+			commandList->WaitUntilCompleted();
+
+			if (TestHelper::GetIsCaptureRequired())
+			{
+				auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
+				auto data = graphics->CaptureRenderTarget(texture);
+				Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat()).Save("Clear.Continue.png");
+			}
+		}
+	}
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(commandList);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
 TestRegister Clear_Basic("Clear.Basic", [](LLGI::DeviceType device) -> void { test_clear(device); });
 
 TestRegister Clear_Update("Clear.Update", [](LLGI::DeviceType device) -> void { test_clear_update(device); });
+
+TestRegister Clear_FrameCount1("Clear.FrameCount1", [](LLGI::DeviceType device) -> void { test_clear_frame_count(device, 1); });
+
+TestRegister Clear_FrameCount3("Clear.FrameCount3", [](LLGI::DeviceType device) -> void { test_clear_frame_count(device, 3); });
+
+TestRegister Clear_Continue("Clear.Continue", [](LLGI::DeviceType device) -> void { test_clear_continue(device, true); });
+
+TestRegister Clear_ContinueWithoutFlush("Clear.ContinueWithoutFlush",
+										[](LLGI::DeviceType device) -> void { test_clear_continue(device, false); });
+
+TestRegister Clear_SyncPoint("Clear.SyncPoint", [](LLGI::DeviceType device) -> void { test_clear_sync_point(device); });
+
+TestRegister Clear_MultipleCommandLists("Clear.MultipleCommandLists",
+										[](LLGI::DeviceType device) -> void { test_clear_multiple_command_lists(device, false); });
+
+TestRegister Clear_SubmissionThread("Clear.SubmissionThread",
+									[](LLGI::DeviceType device) -> void { test_clear_multiple_command_lists(device, true); });
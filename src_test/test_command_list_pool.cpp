@@ -0,0 +1,152 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.CommandListPool.h>
+#include <chrono>
+#include <thread>
+
+/**
+	@brief	measure a time which is spent to get command lists while gpu is busy
+	@return	microseconds in Get
+*/
+int64_t benchmark_command_list_pool(LLGI::DeviceType deviceType, bool isGrowable)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("CommandListPool", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	// a pool which does not grow waits for gpu like a round robin
+	const int32_t initialCount = 2;
+	auto commandListPool =
+		std::make_shared<LLGI::CommandListPool>(graphics, sfMemoryPool, initialCount, isGrowable ? 64 : initialCount);
+
+	// a large target makes gpu slower than cpu
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(2048, 2048);
+	auto renderTexture = graphics->CreateRenderTexture(params);
+	auto renderPass = graphics->CreateRenderPass(&renderTexture, 1, nullptr);
+	renderPass->SetIsColorCleared(true);
+
+	int64_t stallTime = 0;
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		for (int32_t i = 0; i < 8; i++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			auto commandList = commandListPool->Get();
+			stallTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+			commandList->Begin();
+
+			for (int32_t j = 0; j < 16; j++)
+			{
+				renderPass->SetClearColor(LLGI::Color8(static_cast<uint8_t>(j * 16), static_cast<uint8_t>(i * 32), 0, 255));
+				commandList->BeginRenderPass(renderPass);
+				commandList->EndRenderPass();
+			}
+
+			commandList->End();
+			graphics->Execute(commandList);
+			graphics->Flush();
+		}
+
+		platform->Present();
+		count++;
+	}
+
+	std::cout << (isGrowable ? "Growable" : "Fixed") << " : " << stallTime << " us in Get, " << commandListPool->GetCount()
+			  << " command lists" << std::endl;
+
+	// lists are reused instead of being added for each Get
+	if (commandListPool->GetCount() < initialCount || commandListPool->GetCount() > (isGrowable ? 64 : initialCount))
+	{
+		std::cout << "Failed : the pool has " << commandListPool->GetCount() << " command lists." << std::endl;
+		abort();
+	}
+
+	graphics->WaitFinish();
+
+	commandListPool.reset();
+	LLGI::SafeRelease(renderPass);
+	LLGI::SafeRelease(renderTexture);
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	return stallTime;
+}
+
+void test_command_list_pool_thread(LLGI::DeviceType deviceType)
+{
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("CommandListPoolThread", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	{
+		LLGI::ThreadCommandListPool threadPool(graphics, sfMemoryPool, 2);
+
+		LLGI::CommandListPool* pools[2] = {};
+		LLGI::CommandList* commandLists[2] = {};
+
+		std::thread thread([&]() -> void {
+			pools[1] = threadPool.GetPool();
+			commandLists[1] = threadPool.TryGet();
+		});
+
+		pools[0] = threadPool.GetPool();
+		commandLists[0] = threadPool.TryGet();
+		thread.join();
+
+		// each thread has its own pool
+		if (pools[0] == pools[1] || pools[0] != threadPool.GetPool() || commandLists[0] == nullptr || commandLists[1] == nullptr ||
+			commandLists[0] == commandLists[1])
+		{
+			std::cout << "Failed : command lists are shared between threads." << std::endl;
+			abort();
+		}
+
+		// a pool of the thread is kept while other pool is used in the same thread
+		{
+			LLGI::ThreadCommandListPool otherPool(graphics, sfMemoryPool, 2);
+			if (otherPool.GetPool() == pools[0] || threadPool.GetPool() != pools[0])
+			{
+				std::cout << "Failed : a pool of the thread is changed by other pool." << std::endl;
+				abort();
+			}
+		}
+	}
+
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_command_list_pool_benchmark(LLGI::DeviceType deviceType)
+{
+	auto fixedTime = benchmark_command_list_pool(deviceType, false);
+	auto growableTime = benchmark_command_list_pool(deviceType, true);
+
+	std::cout << "Stall time removed : " << (fixedTime - growableTime) << " us" << std::endl;
+}
+
+TestRegister CommandListPool_Benchmark("CommandListPool.Benchmark",
+									   [](LLGI::DeviceType device) -> void { test_command_list_pool_benchmark(device); });
+
+TestRegister CommandListPool_Thread("CommandListPool.Thread",
+									[](LLGI::DeviceType device) -> void { test_command_list_pool_thread(device); });
@@ -0,0 +1,145 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.FrameGraph.h>
+
+void test_frame_graph(LLGI::DeviceType deviceType)
+{
+	const int32_t chainCount = 12;
+	const int32_t frameCount = 3;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("FrameGraph", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreateSharedPtr(LLGI::CreatePlatform(pp, window.get()));
+
+	auto graphics = LLGI::CreateSharedPtr(platform->CreateGraphics());
+	auto sfMemoryPool = LLGI::CreateSharedPtr(graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128));
+	auto commandList = LLGI::CreateSharedPtr(graphics->CreateCommandList(sfMemoryPool.get()));
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(256, 256);
+	auto outputTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	LLGI::FrameGraph frameGraph(graphics.get());
+	int32_t physicalTextureCount = -1;
+
+	for (int32_t frame = 0; frame < frameCount; frame++)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+		frameGraph.Reset();
+
+		auto output = frameGraph.ImportTexture(outputTexture.get());
+
+		// a post processing chain where each pass reads a previous target
+		LLGI::FrameGraphTexture previous;
+		for (int32_t i = 0; i < chainCount; i++)
+		{
+			LLGI::FrameGraphTexture current;
+			frameGraph.AddPass(
+				"Post" + std::to_string(i),
+				[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+					if (previous.IsValid())
+					{
+						builder.Read(previous);
+					}
+					current = builder.CreateTexture(params);
+					builder.WriteColor(current, LLGI::LoadAction::Clear);
+					builder.SetClearColor(LLGI::Color8(static_cast<uint8_t>(i * 16), 255, 0, 255));
+				},
+				nullptr);
+			previous = current;
+		}
+
+		// its output is not used
+		frameGraph.AddPass(
+			"Debug",
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(previous);
+				builder.WriteColor(builder.CreateTexture(params), LLGI::LoadAction::Clear);
+			},
+			nullptr);
+
+		frameGraph.AddPass(
+			"Output",
+			[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+				builder.Read(previous);
+				builder.Write(output);
+			},
+			[&](LLGI::FrameGraphPassContext& context) -> void {
+				context.GetCommandList()->CopyTexture(context.GetTexture(previous), context.GetTexture(output));
+			});
+
+		if (!frameGraph.Compile())
+		{
+			std::cout << "Failed : a frame graph is not compiled." << std::endl;
+			abort();
+		}
+
+		const auto& statistics = frameGraph.GetStatistics();
+		if (statistics.CulledPassCount != 1 || !frameGraph.GetIsCulled("Debug"))
+		{
+			std::cout << "Failed : an unused pass is not culled." << std::endl;
+			abort();
+		}
+
+		if (statistics.TransientTextureCount != chainCount || statistics.PhysicalMemorySize * 2 > statistics.TransientMemorySize)
+		{
+			std::cout << "Failed : transient textures are not aliased. " << statistics.PhysicalTextureCount << " / "
+					  << statistics.TransientTextureCount << std::endl;
+			abort();
+		}
+
+		// textures are reused in following frames
+		if (physicalTextureCount >= 0 && physicalTextureCount != statistics.PhysicalTextureCount)
+		{
+			std::cout << "Failed : transient textures are not reused." << std::endl;
+			abort();
+		}
+		physicalTextureCount = statistics.PhysicalTextureCount;
+
+		commandList->WaitUntilCompleted();
+		commandList->Begin();
+		frameGraph.Execute(commandList.get());
+		commandList->End();
+		graphics->Execute(commandList.get());
+
+		platform->Present();
+	}
+
+	// a pass which reads a texture written by a following pass is rejected because passes are not reordered
+	frameGraph.Reset();
+	auto output = frameGraph.ImportTexture(outputTexture.get());
+	LLGI::FrameGraphTexture misordered;
+	frameGraph.AddPass(
+		"Reader",
+		[&](LLGI::FrameGraphPassBuilder& builder) -> void {
+			misordered = builder.CreateTexture(params);
+			builder.Read(misordered);
+			builder.Write(output);
+		},
+		nullptr);
+	frameGraph.AddPass(
+		"Writer", [&](LLGI::FrameGraphPassBuilder& builder) -> void { builder.WriteColor(misordered, LLGI::LoadAction::Clear); }, nullptr);
+
+	if (frameGraph.Compile())
+	{
+		std::cout << "Failed : a frame graph in a wrong order is compiled." << std::endl;
+		abort();
+	}
+	frameGraph.Reset();
+
+	graphics->WaitFinish();
+
+	auto data = graphics->CaptureRenderTarget(outputTexture.get());
+	if (data.size() < 4 || data[0] != (chainCount - 1) * 16 || data[1] != 255 || data[2] != 0)
+	{
+		std::cout << "Failed : an output of a chain is not copied." << std::endl;
+		abort();
+	}
+}
+
+TestRegister FrameGraph_Basic("FrameGraph.Basic", [](LLGI::DeviceType device) -> void { test_frame_graph(device); });
@@ -0,0 +1,133 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <Utils/LLGI.FrameSink.h>
+#include <array>
+#include <mutex>
+
+void test_frame_sink(LLGI::DeviceType deviceType)
+{
+	const int32_t frameCount = 60;
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("FrameSink", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (size_t i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(256, 256);
+	auto renderTexture = graphics->CreateRenderTexture(params);
+	auto renderPass = graphics->CreateRenderPass(&renderTexture, 1, nullptr);
+	renderPass->SetIsColorCleared(true);
+
+	// encoded frames are checked in order
+	std::mutex mutex;
+	std::vector<int64_t> indexes;
+	std::vector<uint8_t> reds;
+
+	LLGI::FrameSinkParameter sinkParam;
+	sinkParam.Format = LLGI::FrameSinkFormatType::PPM;
+	sinkParam.Output = LLGI::FrameSinkOutputType::Callback;
+	sinkParam.Callback = [&](int64_t index, const std::vector<uint8_t>& data) -> void {
+		std::lock_guard<std::mutex> lock(mutex);
+		const std::string header = "P6\n256 256\n255\n";
+		indexes.push_back(index);
+		reds.push_back(data.size() > header.size() ? data[header.size()] : 0);
+	};
+
+	{
+		LLGI::FrameSink sink(sinkParam);
+
+		while (count < frameCount)
+		{
+			if (!platform->NewFrame())
+				break;
+
+			sfMemoryPool->NewFrame();
+
+			auto commandList = commandLists[count % commandLists.size()];
+			commandList->WaitUntilCompleted();
+
+			renderPass->SetClearColor(LLGI::Color8(static_cast<uint8_t>(count), 0, 0, 255));
+
+			commandList->Begin();
+			commandList->BeginRenderPass(renderPass);
+			commandList->EndRenderPass();
+			auto ticket = commandList->ReadbackTexture(renderTexture);
+			commandList->End();
+			graphics->Execute(commandList);
+
+			if (ticket != nullptr)
+			{
+				sink.Submit(ticket);
+				ticket->Release();
+			}
+			else
+			{
+				// a fallback which waits for gpu
+				auto data = graphics->CaptureRenderTarget(renderTexture);
+				sink.Submit(std::move(data), renderTexture->GetSizeAs2D(), renderTexture->GetFormat());
+			}
+
+			platform->Present();
+			count++;
+		}
+
+		sink.Flush();
+
+		if (sink.GetWrittenCount() != count)
+		{
+			std::cout << "Failed : " << sink.GetWrittenCount() << " / " << count << " frames were written." << std::endl;
+			abort();
+		}
+
+		// a ticket which is not executed fails instead of blocking a worker
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->WaitUntilCompleted();
+		commandList->Begin();
+		auto ticket = commandList->ReadbackTexture(renderTexture);
+		commandList->End();
+
+		if (ticket != nullptr)
+		{
+			sink.Submit(ticket);
+			ticket->Release();
+			sink.Flush();
+
+			if (sink.GetFailedCount() != 1)
+			{
+				std::cout << "Failed : a frame which was not executed was not failed." << std::endl;
+				abort();
+			}
+		}
+	}
+
+	for (size_t i = 0; i < indexes.size(); i++)
+	{
+		if (indexes[i] != static_cast<int64_t>(i) || reds[i] != static_cast<uint8_t>(i))
+		{
+			std::cout << "Failed : frames are not written in order." << std::endl;
+			abort();
+		}
+	}
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(renderPass);
+	LLGI::SafeRelease(renderTexture);
+	LLGI::SafeRelease(sfMemoryPool);
+	for (size_t i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+TestRegister FrameSink_Basic("FrameSink.Basic", [](LLGI::DeviceType device) -> void { test_frame_sink(device); });
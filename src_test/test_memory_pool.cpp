@@ -0,0 +1,121 @@
+#include "TestHelper.h"
+#include "test.h"
+
+void test_memory_pool_growth(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+	int64_t peakReservedSize = 0;
+	int32_t previousConstantBufferCount = 0;
+	int32_t quietGrowthCount = -1;
+	const int32_t constantBufferSize = sizeof(float) * 16;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("MemoryPoolGrowth", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+
+	// a pool which is smaller than required in busy frames
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024, 128);
+	sfMemoryPool->SetShrinkFrameCount(10);
+
+	if (sfMemoryPool->GetStatistics().ReservedSize == 0)
+	{
+		std::cout << "Skip : a growable memory pool is not supported." << std::endl;
+		count = 60;
+	}
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		// statistics describe the frame which has just finished
+		const auto frameStatistics = sfMemoryPool->GetStatistics();
+		if (count > 0 && frameStatistics.ReservedSize > 0)
+		{
+			if (frameStatistics.AllocationCount != previousConstantBufferCount ||
+				frameStatistics.RequestedSize != static_cast<int64_t>(previousConstantBufferCount) * constantBufferSize)
+			{
+				std::cout << "Failed : statistics do not match allocations in a frame " << count - 1 << std::endl;
+				abort();
+			}
+
+			if (frameStatistics.UsedSize < frameStatistics.RequestedSize || frameStatistics.UsedSize > frameStatistics.ReservedSize)
+			{
+				std::cout << "Failed : used size is out of range in a frame " << count - 1 << std::endl;
+				abort();
+			}
+		}
+
+		const auto constantBufferCount = count < 20 ? 64 : 2;
+
+		for (int i = 0; i < constantBufferCount; i++)
+		{
+			auto cb = sfMemoryPool->CreateConstantBuffer(constantBufferSize);
+			if (cb == nullptr)
+			{
+				std::cout << "Failed : CreateConstantBuffer returned nullptr in a frame " << count << std::endl;
+				abort();
+			}
+
+			auto data = static_cast<float*>(cb->Lock());
+			for (int j = 0; j < 16; j++)
+			{
+				data[j] = static_cast<float>(j);
+			}
+			cb->Unlock();
+
+			LLGI::SafeRelease(cb);
+		}
+
+		platform->Present();
+		previousConstantBufferCount = constantBufferCount;
+		count++;
+
+		peakReservedSize = std::max(peakReservedSize, sfMemoryPool->GetStatistics().ReservedSize);
+
+		// pages are merged after busy frames, so quiet frames must not add pages
+		if (count == 25)
+		{
+			quietGrowthCount = sfMemoryPool->GetStatistics().GrowthCount;
+		}
+	}
+
+	auto statistics = sfMemoryPool->GetStatistics();
+
+	graphics->WaitFinish();
+
+	if (statistics.ReservedSize > 0)
+	{
+		// busy frames require more than an initial size
+		if (statistics.GrowthCount == 0 || statistics.HighWaterMark < 64 * constantBufferSize)
+		{
+			std::cout << "Failed : a memory pool does not grow." << std::endl;
+			abort();
+		}
+
+		// quiet frames return pages to an initial size
+		if (statistics.ShrinkCount == 0 || statistics.ReservedSize >= peakReservedSize)
+		{
+			std::cout << "Failed : a memory pool does not shrink." << std::endl;
+			abort();
+		}
+
+		if (quietGrowthCount >= 0 && statistics.GrowthCount != quietGrowthCount)
+		{
+			std::cout << "Failed : a memory pool grows in quiet frames." << std::endl;
+			abort();
+		}
+	}
+
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+TestRegister MemoryPool_Growth("MemoryPool.Growth", [](LLGI::DeviceType device) -> void { test_memory_pool_growth(device); });
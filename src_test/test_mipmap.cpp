@@ -273,5 +273,45 @@ void test_mipmap(LLGI::DeviceType deviceType)
 
 	LLGI::SafeRelease(compiler);
 }
+
+void test_mipmap_barrier(LLGI::DeviceType deviceType)
+{
+	if (deviceType != LLGI::DeviceType::Vulkan)
+	{
+		std::cout << "Skip : barriers are counted only on Vulkan." << std::endl;
+		return;
+	}
+
+	TestContext context("MipMapBarrier", deviceType);
+
+	LLGI::TextureInitializationParameter texParam;
+	texParam.Format = LLGI::TextureFormatType::R8G8B8A8_UNORM;
+	texParam.Size = LLGI::Vec2I(256, 256);
+	texParam.MipMapCount = 5;
+	auto texture = LLGI::CreateSharedPtr(context.Graphics->CreateTexture(texParam));
+	TestHelper::WriteDummyTexture(texture.get());
+
+	auto commandList = context.CommandLists[0].get();
+	commandList->Begin();
+	commandList->GenerateMipMap(texture.get());
+
+	// transitions of each blit are batched and the last transition of all levels is merged
+	const auto mipCount = texture->GetMipmapCount();
+	const auto statistics = commandList->GetStatistics();
+	commandList->End();
+	context.Graphics->Execute(commandList);
+	context.Graphics->WaitFinish();
+
+	if (statistics.PipelineBarrierCount < 1 || statistics.PipelineBarrierCount > mipCount - 1 || statistics.ImageBarrierCount > mipCount)
+	{
+		std::cout << "Failed : GenerateMipMap recorded " << statistics.PipelineBarrierCount << " pipeline barriers and "
+				  << statistics.ImageBarrierCount << " image barriers for " << mipCount << " levels." << std::endl;
+		abort();
+	}
+}
+
 TestRegister SimpleRender_Tex_MipMap_RGBA8("SimpleRender.Texture_MipMap_RGBA8",
 										   [](LLGI::DeviceType device) -> void { test_mipmap(device); });
+
+TestRegister SimpleRender_Tex_MipMap_Barrier("SimpleRender.Texture_MipMap_Barrier",
+											 [](LLGI::DeviceType device) -> void { test_mipmap_barrier(device); });
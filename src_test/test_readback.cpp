@@ -0,0 +1,179 @@
+#include "TestHelper.h"
+#include "test.h"
+#include <array>
+#include <chrono>
+#include <deque>
+
+/**
+	@brief	measure frames per second of a loop which renders and reads a render target back every frame
+	@param	isAsync	whether CommandList::ReadbackTexture is used instead of Graphics::CaptureRenderTarget
+	@return	frames per second, a negative value if it is not supported
+*/
+double benchmark_readback(LLGI::DeviceType deviceType, bool isAsync)
+{
+	const int32_t frameCount = 120;
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("Readback", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+
+	auto graphics = platform->CreateGraphics();
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	std::array<LLGI::CommandList*, 3> commandLists;
+	for (size_t i = 0; i < commandLists.size(); i++)
+		commandLists[i] = graphics->CreateCommandList(sfMemoryPool);
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(1280, 720);
+	auto renderTexture = graphics->CreateRenderTexture(params);
+	auto renderPass = graphics->CreateRenderPass(&renderTexture, 1, nullptr);
+	renderPass->SetIsColorCleared(true);
+
+	// tickets are read after gpu finishes them without waiting, with frames when they are read back
+	std::deque<std::pair<LLGI::ReadbackTicket*, int32_t>> tickets;
+	bool isSupported = true;
+	uint64_t checksum = 0;
+	int32_t readCount = 0;
+
+	// pixels in corners and a center must be a clear color of the frame
+	auto readPixels = [&](const uint8_t* data, int32_t rowPitch, int32_t frame) -> void {
+		const std::array<LLGI::Vec2I, 3> positions = {
+			LLGI::Vec2I(0, 0), LLGI::Vec2I(params.Size.X / 2, params.Size.Y / 2), LLGI::Vec2I(params.Size.X - 1, params.Size.Y - 1)};
+
+		for (const auto& position : positions)
+		{
+			auto pixel = data + position.Y * rowPitch + position.X * 4;
+			if (pixel[0] != static_cast<uint8_t>(frame) || pixel[1] != 0 || pixel[2] != 0 || pixel[3] != 255)
+			{
+				std::cout << "Failed : a pixel (" << position.X << ", " << position.Y << ") in frame " << frame << " is ("
+						  << static_cast<int32_t>(pixel[0]) << ", " << static_cast<int32_t>(pixel[1]) << ", "
+						  << static_cast<int32_t>(pixel[2]) << ", " << static_cast<int32_t>(pixel[3]) << ")." << std::endl;
+				abort();
+			}
+		}
+
+		checksum += data[0];
+		readCount++;
+	};
+
+	auto readTicket = [&](LLGI::ReadbackTicket* ticket, int32_t frame) -> void {
+		auto data = static_cast<const uint8_t*>(ticket->GetData());
+		if (data != nullptr)
+		{
+			readPixels(data, ticket->GetRowPitch(), frame);
+		}
+		ticket->Release();
+	};
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	while (count < frameCount)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		auto commandList = commandLists[count % commandLists.size()];
+		commandList->WaitUntilCompleted();
+
+		renderPass->SetClearColor(LLGI::Color8(static_cast<uint8_t>(count), 0, 0, 255));
+
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->EndRenderPass();
+
+		if (isAsync)
+		{
+			auto ticket = commandList->ReadbackTexture(renderTexture);
+			if (ticket == nullptr)
+			{
+				isSupported = false;
+			}
+			else
+			{
+				tickets.push_back(std::make_pair(ticket, count));
+			}
+		}
+
+		commandList->End();
+		graphics->Execute(commandList);
+
+		if (isAsync)
+		{
+			while (!tickets.empty() && tickets.front().first->IsCompleted())
+			{
+				readTicket(tickets.front().first, tickets.front().second);
+				tickets.pop_front();
+			}
+		}
+		else
+		{
+			auto data = graphics->CaptureRenderTarget(renderTexture);
+			if (!data.empty())
+			{
+				readPixels(data.data(), params.Size.X * 4, count);
+			}
+		}
+
+		platform->Present();
+		count++;
+
+		if (!isSupported)
+			break;
+	}
+
+	for (auto& ticket : tickets)
+	{
+		ticket.first->Wait();
+		readTicket(ticket.first, ticket.second);
+	}
+	tickets.clear();
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(renderPass);
+	LLGI::SafeRelease(renderTexture);
+	LLGI::SafeRelease(sfMemoryPool);
+	for (size_t i = 0; i < commandLists.size(); i++)
+		LLGI::SafeRelease(commandLists[i]);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+
+	if (!isSupported)
+	{
+		return -1.0;
+	}
+
+	if (readCount != count)
+	{
+		std::cout << "Failed : " << readCount << " / " << count << " frames were read back." << std::endl;
+		abort();
+	}
+
+	auto fps = elapsed > 0 ? count * 1000000.0 / elapsed : 0.0;
+	std::cout << (isAsync ? "ReadbackTexture" : "CaptureRenderTarget") << " : " << fps << " fps (" << checksum << ")" << std::endl;
+	return fps;
+}
+
+void test_readback_benchmark(LLGI::DeviceType deviceType)
+{
+	auto beforeFps = benchmark_readback(deviceType, false);
+	auto afterFps = benchmark_readback(deviceType, true);
+
+	if (afterFps < 0.0)
+	{
+		std::cout << "Skip : ReadbackTexture is not supported." << std::endl;
+		return;
+	}
+
+	std::cout << "Readback : " << beforeFps << " fps -> " << afterFps << " fps" << std::endl;
+}
+
+TestRegister Readback_Benchmark("Readback.Benchmark", [](LLGI::DeviceType device) -> void { test_readback_benchmark(device); });
@@ -1,6 +1,7 @@
 #include "TestHelper.h"
 #include "test.h"
 #include <array>
+#include <chrono>
 #include <map>
 
 enum class RenderPassTestMode
@@ -75,6 +76,10 @@ void test_renderPass(LLGI::DeviceType deviceType, RenderPassTestMode mode)
 		if (graphics->IsResolvedDepthSupported())
 		{
 			renderPass = graphics->CreateRenderPass(renderTexture, renderTextureDst, depthTexture, depthTextureDst);
+
+			// multisampled contents are discarded and only resolved textures are written
+			renderPass->SetColorStoreAction(0, LLGI::StoreAction::Resolve);
+			renderPass->SetDepthStoreAction(LLGI::StoreAction::Resolve);
 		}
 		else
 		{
@@ -608,6 +613,613 @@ void test_multiRenderPass(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(compiler);
 }
 
+void test_renderPassCompatibility(LLGI::DeviceType deviceType)
+{
+	TestContext context("RenderPassCompatibility", deviceType);
+	auto graphics = context.Graphics.get();
+
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = LLGI::Vec2I(256, 256);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = renderTexParam.Size;
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderTexturePtr = renderTexture.get();
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&renderTexturePtr, 1, depthTexture.get()));
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5f, 0.5f, 0.5f),
+								LLGI::Vec3F(0.5f, -0.5f, 0.5f),
+								LLGI::Color8(0, 255, 0, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	// a pipeline is created with a clearing pass and used with loading passes
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetIsDepthCleared(true);
+	auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+	auto pip = TestHelper::CreatePipelineState(graphics, renderPass.get(), shader_vs.get(), shader_ps.get());
+
+	int32_t clearedCount = -1;
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		auto isCleared = count % 2 == 0;
+		renderPass->SetIsColorCleared(isCleared);
+		renderPass->SetIsDepthCleared(isCleared);
+		renderPass->SetClearColor(LLGI::Color8(static_cast<uint8_t>(count), 0, 0, 255));
+
+		if (isCleared)
+		{
+			clearedCount = count;
+		}
+		else
+		{
+			// contents are loaded
+			renderPass->SetColorLoadAction(0, LLGI::LoadAction::Load);
+		}
+
+		auto current = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass.get()));
+		if (current != nullptr && current.get() != renderPassPipelineState.get())
+		{
+			std::cout << "Failed : load operations change a compatibility class." << std::endl;
+			abort();
+		}
+
+		auto commandList = context.BeginCommandList(count);
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pip.get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+	}
+
+	// the pipeline draws with passes which load contents, so a clear color of a last cleared frame is kept around the rectangle
+	const std::vector<LLGI::Vec2I> positions = {LLGI::Vec2I(128, 128), LLGI::Vec2I(4, 4)};
+	auto pixels = TestHelper::ReadPixels(graphics, renderTexture.get(), positions);
+	if (pixels.empty() || clearedCount < 0)
+	{
+		std::cout << "Skip : a render texture cannot be read back." << std::endl;
+		return;
+	}
+
+	if (pixels[0].R != 0 || pixels[0].G != 255 || pixels[1].R != static_cast<uint8_t>(clearedCount) || pixels[1].G != 0)
+	{
+		std::cout << "Failed : a render texture is not rendered with a compatible pipeline." << std::endl;
+		abort();
+	}
+}
+
+void test_renderPassDepthOnly(LLGI::DeviceType deviceType)
+{
+	TestContext context("RenderPassDepthOnly", deviceType);
+	auto graphics = context.Graphics.get();
+
+	// a shadow map without a color target
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = LLGI::Vec2I(256, 256);
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(nullptr, 0, depthTexture.get()));
+	if (renderPass == nullptr)
+	{
+		std::cout << "Failed : a depth only render pass is not created." << std::endl;
+		abort();
+	}
+
+	assert(renderPass->GetRenderTextureCount() == 0);
+	renderPass->SetIsDepthCleared(true);
+
+	// depth is sampled after the pass
+	renderPass->SetDepthStoreAction(LLGI::StoreAction::Store);
+
+	// sampled depth is written into a render texture which is read back
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = depthParam.Size;
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+	auto renderTexturePtr = renderTexture.get();
+	auto sampleRenderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&renderTexturePtr, 1, nullptr));
+	sampleRenderPass->SetIsColorCleared(true);
+	sampleRenderPass->SetClearColor(LLGI::Color8(0, 0, 0, 255));
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::Shader> shader_tex_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_tex_ps = nullptr;
+	TestHelper::CreateShader(
+		graphics, deviceType, "simple_texture_rectangle.vert", "simple_texture_rectangle.frag", shader_tex_vs, shader_tex_ps);
+
+	// a depth of a rectangle is 0.5 and a cleared depth is 1.0
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(
+		graphics, LLGI::Vec3F(-0.5f, 0.5f, 0.5f), LLGI::Vec3F(0.5f, -0.5f, 0.5f), LLGI::Color8(), LLGI::Color8(), vb, ib);
+
+	// a pipeline without color attachments
+	auto depthPip = TestHelper::CreatePipelineState(graphics, renderPass.get(), shader_vs.get(), shader_ps.get(), true);
+	auto samplePip = TestHelper::CreatePipelineState(graphics, sampleRenderPass.get(), shader_tex_vs.get(), shader_tex_ps.get());
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		auto commandList = context.BeginCommandList(count);
+
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(depthPip.get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(sampleRenderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(samplePip.get());
+		commandList->SetTexture(
+			depthTexture.get(), LLGI::TextureWrapMode::Clamp, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+	}
+
+	// the rectangle covers a center half of the render texture and maps the whole depth texture
+	// so that its center samples the rectangle in depth and its border samples a cleared depth
+	const std::vector<LLGI::Vec2I> positions = {LLGI::Vec2I(128, 128), LLGI::Vec2I(68, 68)};
+	auto pixels = TestHelper::ReadPixels(graphics, renderTexture.get(), positions);
+	if (pixels.empty())
+	{
+		std::cout << "Skip : a render texture cannot be read back." << std::endl;
+		return;
+	}
+
+	if (pixels[0].R < 96 || pixels[0].R > 160 || pixels[1].R < 250)
+	{
+		std::cout << "Failed : sampled depth is (" << static_cast<int32_t>(pixels[0].R) << ", " << static_cast<int32_t>(pixels[1].R)
+				  << ")." << std::endl;
+		abort();
+	}
+}
+
+void test_renderPassResolvedDepth(LLGI::DeviceType deviceType)
+{
+	TestContext context("RenderPassResolvedDepth", deviceType);
+	auto graphics = context.Graphics.get();
+
+	if (!graphics->IsResolvedDepthSupported())
+	{
+		std::cout << "Skip : resolving depth is not supported." << std::endl;
+		return;
+	}
+
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = LLGI::Vec2I(256, 256);
+	renderTexParam.SamplingCount = 4;
+	auto msaaTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	renderTexParam.SamplingCount = 1;
+	auto resolvedTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = renderTexParam.Size;
+	depthParam.SamplingCount = 4;
+	auto msaaDepthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	depthParam.SamplingCount = 1;
+	auto resolvedDepthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderPass = LLGI::CreateSharedPtr(
+		graphics->CreateRenderPass(msaaTexture.get(), resolvedTexture.get(), msaaDepthTexture.get(), resolvedDepthTexture.get()));
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetIsDepthCleared(true);
+
+	// multisampled contents are discarded and only resolved textures are written
+	renderPass->SetColorStoreAction(0, LLGI::StoreAction::Resolve);
+	renderPass->SetDepthStoreAction(LLGI::StoreAction::Resolve);
+
+	// resolved depth is written into a render texture which is read back
+	auto sampledTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+	auto sampledTexturePtr = sampledTexture.get();
+	auto sampleRenderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&sampledTexturePtr, 1, nullptr));
+	sampleRenderPass->SetIsColorCleared(true);
+	sampleRenderPass->SetClearColor(LLGI::Color8(0, 0, 0, 255));
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::Shader> shader_tex_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_tex_ps = nullptr;
+	TestHelper::CreateShader(
+		graphics, deviceType, "simple_texture_rectangle.vert", "simple_texture_rectangle.frag", shader_tex_vs, shader_tex_ps);
+
+	// a depth of a rectangle is 0.5 and a cleared depth is 1.0
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(
+		graphics, LLGI::Vec3F(-0.5f, 0.5f, 0.5f), LLGI::Vec3F(0.5f, -0.5f, 0.5f), LLGI::Color8(), LLGI::Color8(), vb, ib);
+
+	auto depthPip = TestHelper::CreatePipelineState(graphics, renderPass.get(), shader_vs.get(), shader_ps.get(), true);
+	auto samplePip = TestHelper::CreatePipelineState(graphics, sampleRenderPass.get(), shader_tex_vs.get(), shader_tex_ps.get());
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		auto commandList = context.BeginCommandList(count);
+
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(depthPip.get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(sampleRenderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(samplePip.get());
+		commandList->SetTexture(resolvedDepthTexture.get(),
+								LLGI::TextureWrapMode::Clamp,
+								LLGI::TextureMinMagFilter::Nearest,
+								0,
+								LLGI::ShaderStageType::Pixel);
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+	}
+
+	// same as a depth only pass, the center samples the rectangle and the border samples a cleared depth
+	const std::vector<LLGI::Vec2I> positions = {LLGI::Vec2I(128, 128), LLGI::Vec2I(68, 68)};
+	auto pixels = TestHelper::ReadPixels(graphics, sampledTexture.get(), positions);
+	if (pixels.empty())
+	{
+		std::cout << "Skip : a render texture cannot be read back." << std::endl;
+		return;
+	}
+
+	if (pixels[0].R < 96 || pixels[0].R > 160 || pixels[1].R < 250)
+	{
+		std::cout << "Failed : resolved depth is (" << static_cast<int32_t>(pixels[0].R) << ", " << static_cast<int32_t>(pixels[1].R)
+				  << ")." << std::endl;
+		abort();
+	}
+}
+
+void test_renderPassPerFrame(LLGI::DeviceType deviceType)
+{
+	TestContext context("RenderPassPerFrame", deviceType);
+	auto graphics = context.Graphics.get();
+
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = LLGI::Vec2I(256, 256);
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = renderTexParam.Size;
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	std::shared_ptr<LLGI::Texture> renderTexture;
+	LLGI::Color8 clearColor;
+
+	// framebuffers are reused by render passes which are created every frame
+	int32_t firstFramebufferCount = 0;
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		// attachments are replaced sometimes, and resources which refer them are evicted
+		if (count % 20 == 0)
+		{
+			graphics->WaitFinish();
+			renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+		}
+
+		// a render pass is created every frame
+		auto renderTexturePtr = renderTexture.get();
+		auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&renderTexturePtr, 1, depthTexture.get()));
+		clearColor = LLGI::Color8(static_cast<uint8_t>(count * 4), 0, 0, 255);
+		renderPass->SetIsColorCleared(true);
+		renderPass->SetIsDepthCleared(true);
+		renderPass->SetClearColor(clearColor);
+
+		auto commandList = context.BeginCommandList(count);
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->EndRenderPass();
+
+		commandList->BeginRenderPass(context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+
+		// a replaced render texture may be alive until command lists which refer it are reused
+		const auto framebufferCount = graphics->GetFramebufferCacheStatistics().FramebufferCount;
+		if (count == 0)
+		{
+			firstFramebufferCount = framebufferCount;
+		}
+		else if (framebufferCount > firstFramebufferCount + 1)
+		{
+			std::cout << "Failed : framebuffers increased from " << firstFramebufferCount << " to " << framebufferCount << "." << std::endl;
+			abort();
+		}
+	}
+
+	// a reused framebuffer must refer a current render texture
+	auto pixels = TestHelper::ReadPixels(graphics, renderTexture.get(), {LLGI::Vec2I(128, 128)});
+	if (!pixels.empty() && pixels[0].R != clearColor.R)
+	{
+		std::cout << "Failed : a render texture is not cleared with a reused framebuffer." << std::endl;
+		abort();
+	}
+}
+
+void test_renderPassDynamicRendering(LLGI::DeviceType deviceType)
+{
+	// it falls back to render pass objects if it is not supported
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	pp.UseDynamicRendering = true;
+	TestContext context("RenderPassDynamicRendering", pp);
+	auto graphics = context.Graphics.get();
+
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = LLGI::Vec2I(256, 256);
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = renderTexParam.Size;
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderTexturePtr = renderTexture.get();
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&renderTexturePtr, 1, depthTexture.get()));
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetIsDepthCleared(true);
+	renderPass->SetClearColor(LLGI::Color8(0, 0, 64, 255));
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::Shader> shader_tex_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_tex_ps = nullptr;
+	TestHelper::CreateShader(
+		graphics, deviceType, "simple_texture_rectangle.vert", "simple_texture_rectangle.frag", shader_tex_vs, shader_tex_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5f, 0.5f, 0.5f),
+								LLGI::Vec3F(0.5f, -0.5f, 0.5f),
+								LLGI::Color8(0, 255, 0, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	auto pip = TestHelper::CreatePipelineState(graphics, renderPass.get(), shader_vs.get(), shader_ps.get(), true);
+	std::shared_ptr<LLGI::PipelineState> screenPip;
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		auto commandList = context.BeginCommandList(count);
+
+		commandList->BeginRenderPass(renderPass.get());
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pip.get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		auto screenRenderPass = context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true);
+		if (screenPip == nullptr)
+		{
+			screenPip = TestHelper::CreatePipelineState(graphics, screenRenderPass, shader_tex_vs.get(), shader_tex_ps.get());
+		}
+
+		commandList->BeginRenderPass(screenRenderPass);
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(screenPip.get());
+		commandList->SetTexture(
+			renderTexture.get(), LLGI::TextureWrapMode::Clamp, LLGI::TextureMinMagFilter::Nearest, 0, LLGI::ShaderStageType::Pixel);
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+	}
+
+	// the rectangle is rendered over a clear color
+	const std::vector<LLGI::Vec2I> positions = {LLGI::Vec2I(128, 128), LLGI::Vec2I(4, 4)};
+	auto pixels = TestHelper::ReadPixels(graphics, renderTexture.get(), positions);
+	if (pixels.empty())
+	{
+		std::cout << "Skip : a render texture cannot be read back." << std::endl;
+		return;
+	}
+
+	if (pixels[0].G != 255 || pixels[0].B != 0 || pixels[1].G != 0 || pixels[1].B != 64)
+	{
+		std::cout << "Failed : a render texture is not rendered with dynamic rendering." << std::endl;
+		abort();
+	}
+}
+
+/**
+	@brief	measure a time of frames which consist of several multisampled passes
+	@param	isDiscarded	whether attachments which are not read later are discarded
+	@return	microseconds
+*/
+int64_t benchmark_renderPassLoadStore(LLGI::DeviceType deviceType, bool isDiscarded)
+{
+	const int32_t passCount = 8;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	TestContext context("RenderPassLoadStore", pp);
+	auto graphics = context.Graphics.get();
+
+	// large multisampled targets make a bandwidth dominant
+	LLGI::RenderTextureInitializationParameter renderTexParam;
+	renderTexParam.Size = LLGI::Vec2I(2048, 2048);
+	renderTexParam.SamplingCount = 4;
+	auto renderTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	renderTexParam.SamplingCount = 1;
+	auto resolvedTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(renderTexParam));
+
+	LLGI::DepthTextureInitializationParameter depthParam;
+	depthParam.Size = renderTexParam.Size;
+	depthParam.SamplingCount = 4;
+	auto depthTexture = LLGI::CreateSharedPtr(graphics->CreateDepthTexture(depthParam));
+
+	auto renderPass =
+		LLGI::CreateSharedPtr(graphics->CreateRenderPass(renderTexture.get(), resolvedTexture.get(), depthTexture.get(), nullptr));
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetIsDepthCleared(true);
+	renderPass->SetClearColor(LLGI::Color8(0, 0, 64, 255));
+
+	if (isDiscarded)
+	{
+		// only a resolved texture is read after each pass
+		renderPass->SetColorStoreAction(0, LLGI::StoreAction::Resolve);
+		renderPass->SetDepthStoreAction(LLGI::StoreAction::DontCare);
+	}
+	else if (renderPass->GetDepthStoreAction() != LLGI::StoreAction::Store)
+	{
+		std::cout << "Failed : depth is not stored by default." << std::endl;
+		abort();
+	}
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::shared_ptr<LLGI::VertexBuffer> vb;
+	std::shared_ptr<LLGI::IndexBuffer> ib;
+	TestHelper::CreateRectangle(graphics,
+								LLGI::Vec3F(-0.5f, 0.5f, 0.5f),
+								LLGI::Vec3F(0.5f, -0.5f, 0.5f),
+								LLGI::Color8(0, 255, 0, 255),
+								LLGI::Color8(0, 255, 0, 255),
+								vb,
+								ib);
+
+	auto pip = TestHelper::CreatePipelineState(graphics, renderPass.get(), shader_vs.get(), shader_ps.get(), true);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int32_t count = 0; count < 60 && context.NewFrame(); count++)
+	{
+		auto commandList = context.BeginCommandList(count);
+
+		for (int32_t i = 0; i < passCount; i++)
+		{
+			commandList->BeginRenderPass(renderPass.get());
+			commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+			commandList->SetIndexBuffer(ib.get());
+			commandList->SetPipelineState(pip.get());
+			commandList->Draw(2);
+			commandList->EndRenderPass();
+		}
+
+		commandList->BeginRenderPass(context.Platform->GetCurrentScreen(LLGI::Color8(0, 0, 0, 255), true));
+		commandList->EndRenderPass();
+
+		context.Present(commandList);
+	}
+
+	graphics->WaitFinish();
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+	std::cout << (isDiscarded ? "Discarded" : "Stored") << " : " << elapsed << " us" << std::endl;
+
+	// discarding multisampled attachments must not change a resolved result
+	const std::vector<LLGI::Vec2I> positions = {LLGI::Vec2I(1024, 1024), LLGI::Vec2I(4, 4)};
+	auto pixels = TestHelper::ReadPixels(graphics, resolvedTexture.get(), positions);
+	if (!pixels.empty() && (pixels[0].G != 255 || pixels[0].B != 0 || pixels[1].G != 0 || pixels[1].B != 64))
+	{
+		std::cout << "Failed : a resolved texture is not rendered when attachments are " << (isDiscarded ? "discarded." : "stored.")
+				  << std::endl;
+		abort();
+	}
+
+	return elapsed;
+}
+
+void test_renderPassLoadStore(LLGI::DeviceType deviceType)
+{
+	auto storedTime = benchmark_renderPassLoadStore(deviceType, false);
+	auto discardedTime = benchmark_renderPassLoadStore(deviceType, true);
+
+	std::cout << "LoadStore : " << storedTime << " us -> " << discardedTime << " us" << std::endl;
+}
+
+void test_renderPassExecutionOrder(LLGI::DeviceType deviceType)
+{
+	TestContext context("RenderPassExecutionOrder", deviceType);
+	auto graphics = context.Graphics.get();
+	auto copyCommandList = context.CommandLists[0].get();
+	auto clearCommandList = context.CommandLists[1].get();
+
+	LLGI::RenderTextureInitializationParameter params;
+	params.Size = LLGI::Vec2I(64, 64);
+	auto srcTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+	auto dstTexture = LLGI::CreateSharedPtr(graphics->CreateRenderTexture(params));
+
+	auto srcTexturePtr = srcTexture.get();
+	auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&srcTexturePtr, 1, nullptr));
+	renderPass->SetIsColorCleared(true);
+	renderPass->SetClearColor(LLGI::Color8(0, 255, 0, 255));
+
+	if (!context.NewFrame())
+	{
+		return;
+	}
+
+	// a copy is recorded before a source is rendered, but executed after it
+	copyCommandList->Begin();
+	copyCommandList->CopyTexture(srcTexture.get(), dstTexture.get());
+	copyCommandList->End();
+
+	clearCommandList->Begin();
+	clearCommandList->BeginRenderPass(renderPass.get());
+	clearCommandList->EndRenderPass();
+	clearCommandList->End();
+
+	graphics->Execute(clearCommandList);
+	graphics->Execute(copyCommandList);
+
+	context.Platform->Present();
+
+	auto pixels = TestHelper::ReadPixels(graphics, dstTexture.get(), {LLGI::Vec2I(0, 0)});
+	if (pixels.empty() || pixels[0].R != 0 || pixels[0].G != 255 || pixels[0].B != 0)
+	{
+		std::cout << "Failed : a copied texture is not rendered." << std::endl;
+		abort();
+	}
+}
+
 TestRegister RenderPass_Basic("RenderPass.Basic",
 							  [](LLGI::DeviceType device) -> void { test_renderPass(device, RenderPassTestMode::None); });
 
@@ -623,3 +1235,21 @@ TestRegister RenderPass_CopyTextureToScreen("RenderPass.CopyTextureToScreen",
 											[](LLGI::DeviceType device) -> void { test_copyTextureToScreen(device); });
 
 TestRegister RenderPass_MRT("RenderPass.MRT", [](LLGI::DeviceType device) -> void { test_multiRenderPass(device); });
+
+TestRegister RenderPass_Compatibility("RenderPass.Compatibility",
+									  [](LLGI::DeviceType device) -> void { test_renderPassCompatibility(device); });
+
+TestRegister RenderPass_DepthOnly("RenderPass.DepthOnly", [](LLGI::DeviceType device) -> void { test_renderPassDepthOnly(device); });
+
+TestRegister RenderPass_ResolvedDepth("RenderPass.ResolvedDepth",
+									  [](LLGI::DeviceType device) -> void { test_renderPassResolvedDepth(device); });
+
+TestRegister RenderPass_PerFrame("RenderPass.PerFrame", [](LLGI::DeviceType device) -> void { test_renderPassPerFrame(device); });
+
+TestRegister RenderPass_DynamicRendering("RenderPass.DynamicRendering",
+										 [](LLGI::DeviceType device) -> void { test_renderPassDynamicRendering(device); });
+
+TestRegister RenderPass_LoadStore("RenderPass.LoadStore", [](LLGI::DeviceType device) -> void { test_renderPassLoadStore(device); });
+
+TestRegister RenderPass_ExecutionOrder("RenderPass.ExecutionOrder",
+									   [](LLGI::DeviceType device) -> void { test_renderPassExecutionOrder(device); });
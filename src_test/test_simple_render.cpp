@@ -269,7 +269,133 @@ void test_index_offset(LLGI::DeviceType deviceType)
 	LLGI::SafeRelease(platform);
 }
 
-void test_simple_constant_rectangle(LLGI::ConstantBufferType type, LLGI::DeviceType deviceType)
+void test_transient_buffer(LLGI::DeviceType deviceType)
+{
+	int count = 0;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = true;
+	auto window = std::unique_ptr<LLGI::Window>(LLGI::CreateWindow("TransientBuffer", LLGI::Vec2I(1280, 720)));
+	auto platform = LLGI::CreatePlatform(pp, window.get());
+	LLGI::SafeAddRef(platform);
+
+	auto graphics = platform->CreateGraphics();
+	graphics->SetDisposed([platform]() -> void { platform->Release(); });
+
+	auto sfMemoryPool = graphics->CreateSingleFrameMemoryPool(1024 * 1024, 128);
+
+	auto commandListPool = std::make_shared<LLGI::CommandListPool>(graphics, sfMemoryPool, 3);
+
+	std::shared_ptr<LLGI::Shader> shader_vs = nullptr;
+	std::shared_ptr<LLGI::Shader> shader_ps = nullptr;
+
+	TestHelper::CreateShader(graphics, deviceType, "simple_rectangle.vert", "simple_rectangle.frag", shader_vs, shader_ps);
+
+	std::map<std::shared_ptr<LLGI::RenderPassPipelineState>, std::shared_ptr<LLGI::PipelineState>> pips;
+
+	while (count < 60)
+	{
+		if (!platform->NewFrame())
+			break;
+
+		sfMemoryPool->NewFrame();
+
+		// geometry is rebuilt every frame
+		auto vb = LLGI::CreateSharedPtr(sfMemoryPool->CreateVertexBuffer(sizeof(SimpleVertex) * 4));
+		auto ib = LLGI::CreateSharedPtr(sfMemoryPool->CreateIndexBuffer(2, 6));
+
+		if (vb == nullptr || ib == nullptr)
+		{
+			std::cout << "Skip : transient buffers are not supported." << std::endl;
+			break;
+		}
+
+		auto x = (count % 60) / 60.0f - 0.5f;
+		auto vb_buf = (SimpleVertex*)vb->Lock();
+		vb_buf[0].Pos = LLGI::Vec3F(x, 0.5f, 0.5f);
+		vb_buf[1].Pos = LLGI::Vec3F(x + 0.5f, 0.5f, 0.5f);
+		vb_buf[2].Pos = LLGI::Vec3F(x + 0.5f, -0.5f, 0.5f);
+		vb_buf[3].Pos = LLGI::Vec3F(x, -0.5f, 0.5f);
+		vb_buf[0].UV = LLGI::Vec2F(0.0f, 0.0f);
+		vb_buf[1].UV = LLGI::Vec2F(1.0f, 0.0f);
+		vb_buf[2].UV = LLGI::Vec2F(1.0f, 1.0f);
+		vb_buf[3].UV = LLGI::Vec2F(0.0f, 1.0f);
+		vb_buf[0].Color = LLGI::Color8(255, 255, 255, 255);
+		vb_buf[1].Color = LLGI::Color8(255, 255, 0, 255);
+		vb_buf[2].Color = LLGI::Color8(0, 255, 0, 255);
+		vb_buf[3].Color = LLGI::Color8(0, 255, 255, 255);
+		vb->Unlock();
+
+		auto ib_buf = (uint16_t*)ib->Lock();
+		ib_buf[0] = 0;
+		ib_buf[1] = 1;
+		ib_buf[2] = 2;
+		ib_buf[3] = 0;
+		ib_buf[4] = 2;
+		ib_buf[5] = 3;
+		ib->Unlock();
+
+		auto renderPass = platform->GetCurrentScreen(LLGI::Color8(), true, false);
+		auto renderPassPipelineState = LLGI::CreateSharedPtr(graphics->CreateRenderPassPipelineState(renderPass));
+
+		if (pips.count(renderPassPipelineState) == 0)
+		{
+			auto pip = graphics->CreatePiplineState();
+			pip->VertexLayouts[0] = LLGI::VertexLayoutFormat::R32G32B32_FLOAT;
+			pip->VertexLayouts[1] = LLGI::VertexLayoutFormat::R32G32_FLOAT;
+			pip->VertexLayouts[2] = LLGI::VertexLayoutFormat::R8G8B8A8_UNORM;
+			pip->VertexLayoutNames[0] = "POSITION";
+			pip->VertexLayoutNames[1] = "UV";
+			pip->VertexLayoutNames[2] = "COLOR";
+			pip->VertexLayoutCount = 3;
+
+			pip->SetShader(LLGI::ShaderStageType::Vertex, shader_vs.get());
+			pip->SetShader(LLGI::ShaderStageType::Pixel, shader_ps.get());
+			pip->SetRenderPassPipelineState(renderPassPipelineState.get());
+			pip->Compile();
+
+			pips[renderPassPipelineState] = LLGI::CreateSharedPtr(pip);
+		}
+
+		auto commandList = commandListPool->Get();
+		commandList->Begin();
+		commandList->BeginRenderPass(renderPass);
+		commandList->SetVertexBuffer(vb.get(), sizeof(SimpleVertex), 0);
+		commandList->SetIndexBuffer(ib.get());
+		commandList->SetPipelineState(pips[renderPassPipelineState].get());
+		commandList->Draw(2);
+		commandList->EndRenderPass();
+		commandList->End();
+
+		graphics->Execute(commandList);
+
+		platform->Present();
+		count++;
+
+		if (TestHelper::GetIsCaptureRequired() && count == 30)
+		{
+			commandList->WaitUntilCompleted();
+			auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
+			auto data = graphics->CaptureRenderTarget(texture);
+			Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat())
+				.Save("SimpleRender.TransientBuffer.png");
+			break;
+		}
+	}
+
+	pips.clear();
+
+	graphics->WaitFinish();
+
+	LLGI::SafeRelease(sfMemoryPool);
+	LLGI::SafeRelease(graphics);
+	LLGI::SafeRelease(platform);
+}
+
+void test_simple_constant_rectangle(LLGI::ConstantBufferType type,
+									LLGI::DeviceType deviceType,
+									LLGI::LockMode lockMode = LLGI::LockMode::Default)
 {
 	auto code_gl_vs = R"(
 #version 440 core
@@ -471,6 +597,16 @@ void main()
 			cb_ps_buf[3] = 0.0f;
 			cb_ps->Unlock();
 		}
+		else if (lockMode == LLGI::LockMode::Discard)
+		{
+			// a long time buffer is rewritten while a previous frame may read it
+			auto cb_vs_buf = (float*)cb_vs->Lock(LLGI::LockMode::Discard);
+			cb_vs_buf[0] = 0.2f;
+			cb_vs_buf[1] = 0.0f;
+			cb_vs_buf[2] = 0.0f;
+			cb_vs_buf[3] = 0.0f;
+			cb_vs->Unlock();
+		}
 
 		LLGI::Color8 color;
 		color.R = count % 255;
@@ -530,7 +666,12 @@ void main()
 			auto texture = platform->GetCurrentScreen(LLGI::Color8(), true)->GetRenderTexture(0);
 			auto data = graphics->CaptureRenderTarget(texture);
 
-			if (type == LLGI::ConstantBufferType::LongTime)
+			if (type == LLGI::ConstantBufferType::LongTime && lockMode == LLGI::LockMode::Discard)
+			{
+				Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat())
+					.Save("SimpleRender.ConstantLTDiscard.png");
+			}
+			else if (type == LLGI::ConstantBufferType::LongTime)
 			{
 				Bitmap2D(data, texture->GetSizeAs2D().X, texture->GetSizeAs2D().Y, texture->GetFormat())
 					.Save("SimpleRender.ConstantLT.png");
@@ -1064,10 +1205,17 @@ TestRegister SimpleRender_BasicPoint("SimpleRender.BasicPoint", [](LLGI::DeviceT
 
 TestRegister SimpleRender_IndexOffset("SimpleRender.IndexOffset", [](LLGI::DeviceType device) -> void { test_index_offset(device); });
 
+TestRegister SimpleRender_TransientBuffer("SimpleRender.TransientBuffer",
+										  [](LLGI::DeviceType device) -> void { test_transient_buffer(device); });
+
 TestRegister SimpleRender_ConstantLT("SimpleRender.ConstantLT", [](LLGI::DeviceType device) -> void {
 	test_simple_constant_rectangle(LLGI::ConstantBufferType::LongTime, device);
 });
 
+TestRegister SimpleRender_ConstantLTDiscard("SimpleRender.ConstantLTDiscard", [](LLGI::DeviceType device) -> void {
+	test_simple_constant_rectangle(LLGI::ConstantBufferType::LongTime, device, LLGI::LockMode::Discard);
+});
+
 TestRegister SimpleRender_ConstantST("SimpleRender.ConstantST", [](LLGI::DeviceType device) -> void {
 	test_simple_constant_rectangle(LLGI::ConstantBufferType::ShortTime, device);
 });
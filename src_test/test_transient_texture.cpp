@@ -0,0 +1,111 @@
+#include "TestHelper.h"
+#include "test.h"
+
+void test_transient_texture(LLGI::DeviceType deviceType, bool isPresented)
+{
+	const int32_t frameCount = 40;
+
+	LLGI::PlatformParameter pp;
+	pp.Device = deviceType;
+	pp.WaitVSync = false;
+	TestContext context("TransientTexture", pp);
+	auto graphics = context.Graphics.get();
+	auto commandList = context.CommandLists[0].get();
+
+	graphics->SetTransientRenderTextureTrimFrameCount(10);
+
+	for (int32_t frame = 0; frame < frameCount; frame++)
+	{
+		// a frame ends explicitly in an offscreen loop
+		if (isPresented)
+		{
+			if (!context.NewFrame())
+				break;
+		}
+		else
+		{
+			context.MemoryPool->NewFrame();
+		}
+
+		// targets of a bloom, a small target is used only in first frames
+		std::vector<LLGI::RenderTextureInitializationParameter> parameters(3);
+		parameters[0].Size = LLGI::Vec2I(256, 256);
+		parameters[1].Size = LLGI::Vec2I(128, 128);
+		parameters[2].Size = LLGI::Vec2I(128, 128);
+
+		if (frame < 10)
+		{
+			parameters.resize(4);
+			parameters[3].Size = LLGI::Vec2I(64, 64);
+		}
+
+		std::vector<LLGI::Texture*> textures;
+		for (const auto& parameter : parameters)
+		{
+			auto texture = graphics->AcquireTransientRenderTexture(parameter);
+			if (texture == nullptr)
+			{
+				std::cout << "Skip : transient render textures are not supported." << std::endl;
+				return;
+			}
+
+			// gpu finishes commands with previous textures in the middle of a frame, but they are still available in the frame
+			for (auto t : textures)
+			{
+				if (t == texture)
+				{
+					std::cout << "Failed : a texture is acquired twice in a frame." << std::endl;
+					abort();
+				}
+			}
+
+			textures.push_back(texture);
+
+			commandList->WaitUntilCompleted();
+			commandList->Begin();
+
+			auto renderPass = LLGI::CreateSharedPtr(graphics->CreateRenderPass(&texture, 1, nullptr));
+			renderPass->SetIsColorCleared(true);
+			renderPass->SetClearColor(LLGI::Color8(0, 255, 0, 255));
+			commandList->BeginRenderPass(renderPass.get());
+			commandList->EndRenderPass();
+
+			commandList->End();
+			graphics->Execute(commandList);
+			commandList->WaitUntilCompleted();
+		}
+
+		if (isPresented)
+		{
+			context.Platform->Present();
+		}
+		else
+		{
+			graphics->EndTransientRenderTextureFrame();
+		}
+	}
+
+	graphics->WaitFinish();
+
+	auto statistics = graphics->GetTransientRenderTexturePoolStatistics();
+
+	// textures are created only for frames in flight
+	if (statistics.ReuseCount * 2 < statistics.AcquireCount || statistics.TextureCount > 24)
+	{
+		std::cout << "Failed : transient render textures are not reused. (" << statistics.ReuseCount << " / " << statistics.AcquireCount
+				  << ", " << statistics.TextureCount << " textures)" << std::endl;
+		abort();
+	}
+
+	if (statistics.TrimCount == 0)
+	{
+		std::cout << "Failed : unused transient render textures are not released." << std::endl;
+		abort();
+	}
+}
+
+TestRegister TransientTexture_Basic("TransientTexture.Basic",
+									[](LLGI::DeviceType device) -> void { test_transient_texture(device, true); });
+
+TestRegister TransientTexture_WithoutPresent("TransientTexture.WithoutPresent",
+											 [](LLGI::DeviceType device) -> void { test_transient_texture(device, false); });